@@ -0,0 +1,156 @@
+/* arena.c - Per-command-line arena allocator for Minishell */
+/* Author: your_login */
+
+#include "minishell.h"
+
+#define ARENA_ALIGN         16
+#define ARENA_MIN_CHUNK     4096
+
+/*
+ * Everything built while processing one command line (tokens, t_cmd,
+ * argv arrays, expanded strings) is bump-allocated from the arena and
+ * released at once by arena_reset. When a line needed more than one
+ * chunk, the chunks are merged into a single larger one on reset so the
+ * next line of the same size is served without calling malloc.
+ */
+
+/**
+ * arena_new_chunk - Allocate a chunk and make it current
+ * @arena: Arena
+ * @size: Minimum usable size of the chunk
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+static int arena_new_chunk(t_arena *arena, size_t size)
+{
+    t_arena_chunk   *chunk;
+    
+    if (size < ARENA_MIN_CHUNK)
+        size = ARENA_MIN_CHUNK;
+    chunk = malloc(sizeof(t_arena_chunk) + size);
+    if (!chunk)
+        return (-1);
+    chunk->size = size;
+    chunk->used = 0;
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+    arena->reserved += size;
+    return (0);
+}
+
+/**
+ * arena_init - Initialize an arena with one chunk
+ * @arena: Arena to initialize
+ * @size: Initial chunk size
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+int     arena_init(t_arena *arena, size_t size)
+{
+    ft_bzero(arena, sizeof(t_arena));
+    return (arena_new_chunk(arena, size));
+}
+
+/**
+ * arena_alloc - Allocate memory that lives until the next reset
+ * @arena: Arena
+ * @size: Number of bytes
+ *
+ * Return: 16-byte aligned pointer, or NULL on allocation failure
+ */
+void    *arena_alloc(t_arena *arena, size_t size)
+{
+    t_arena_chunk   *chunk;
+    void            *ptr;
+    size_t          grow;
+    
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    chunk = arena->chunks;
+    if (!chunk || chunk->size - chunk->used < size)
+    {
+        /* Double the total reservation, or more for a big request */
+        grow = arena->reserved;
+        if (grow < size)
+            grow = size;
+        if (arena_new_chunk(arena, grow) == -1)
+            return (NULL);
+        chunk = arena->chunks;
+    }
+    ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    arena->used += size;
+    if (arena->used > arena->high_water)
+        arena->high_water = arena->used;
+    return (ptr);
+}
+
+/**
+ * arena_strndup - Copy n bytes into the arena as a NUL-terminated string
+ * @arena: Arena
+ * @s: Source bytes
+ * @n: Number of bytes to copy
+ *
+ * Return: New string or NULL on allocation failure
+ */
+char    *arena_strndup(t_arena *arena, const char *s, size_t n)
+{
+    char    *dup;
+    
+    dup = arena_alloc(arena, n + 1);
+    if (!dup)
+        return (NULL);
+    memcpy(dup, s, n);
+    dup[n] = '\0';
+    return (dup);
+}
+
+/**
+ * arena_reset - Release everything allocated since the last reset
+ * @arena: Arena
+ */
+void    arena_reset(t_arena *arena)
+{
+    t_arena_chunk   *chunk;
+    t_arena_chunk   *next;
+    size_t          reserved;
+    
+    arena->line_peak = arena->used;
+    arena->used = 0;
+    if (arena->chunks && arena->chunks->next)
+    {
+        /* Merge into one chunk big enough for this line next time */
+        reserved = arena->reserved;
+        chunk = arena->chunks;
+        while (chunk)
+        {
+            next = chunk->next;
+            free(chunk);
+            chunk = next;
+        }
+        arena->chunks = NULL;
+        arena->reserved = 0;
+        if (arena_new_chunk(arena, reserved) == -1)
+            return;
+    }
+    if (arena->chunks)
+        arena->chunks->used = 0;
+}
+
+/**
+ * arena_destroy - Free every chunk
+ * @arena: Arena
+ */
+void    arena_destroy(t_arena *arena)
+{
+    t_arena_chunk   *chunk;
+    t_arena_chunk   *next;
+    
+    chunk = arena->chunks;
+    while (chunk)
+    {
+        next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    ft_bzero(arena, sizeof(t_arena));
+}
@@ -0,0 +1,583 @@
+/* bench.c - End-to-end benchmark driver for Minishell */
+/* Author: your_login */
+
+/*
+ * Usage: bench [-n commands] [-o results.json] shell...
+ *
+ * Runs every shell over a fixed set of workloads and writes one JSON
+ * document with, per shell and workload:
+ *
+ *   commands_per_sec   commands divided by wall time of the whole run
+ *   latency_us         p50/p99 of per-command latency
+ *   peak_rss_kb        ru_maxrss of the shell (and waited-for children)
+ *   syscalls           syscalls made by the shell itself and in total,
+ *                      counted in a second run under ptrace
+ *
+ * Latency is measured through a pseudo-terminal: the shell sees a tty and
+ * prints its prompt after each command, and the time from sending a
+ * command to seeing the next prompt is one sample. Both minishell and
+ * simple_minishell use the prompt "minishell> ".
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ptrace.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#define PROMPT          "minishell> "
+#define PROMPT_LEN      (sizeof(PROMPT) - 1)
+#define TIMEOUT_MS      10000
+#define LARGE_ENV_VARS  2000
+#define MAX_TRACEES     4096
+
+typedef struct s_workload {
+    const char  *name;
+    int         large_env;      // start the shell with LARGE_ENV_VARS extra vars
+    int         divisor;        // run commands / divisor lines
+    char        *(*make_line)(int i);
+}   t_workload;
+
+typedef struct s_result {
+    int     commands;
+    double  seconds;
+    double  p50_us;
+    double  p99_us;
+    long    peak_rss_kb;
+    long    shell_syscalls;
+    long    total_syscalls;
+    int     ok;
+}   t_result;
+
+/* Workload lines ---------------------------------------------------------- */
+
+static char *line_builtin(int i)
+{
+    (void)i;
+    return (strdup("echo hello world"));
+}
+
+static char *line_external(int i)
+{
+    (void)i;
+    return (strdup("/bin/true"));
+}
+
+static char *line_expansion(int i)
+{
+    char    *line;
+    size_t  len;
+    int     k;
+
+    (void)i;
+    line = malloc(4096);
+    if (!line)
+        return (NULL);
+    len = (size_t)sprintf(line, "echo");
+    k = 0;
+    while (k < 40)
+    {
+        len += sprintf(line + len, " $HOME:$USER:$BENCH_VAR");
+        k++;
+    }
+    return (line);
+}
+
+static char *line_long(int i)
+{
+    char    *line;
+    size_t  k;
+
+    (void)i;
+    line = malloc(16384);
+    if (!line)
+        return (NULL);
+    memcpy(line, "echo", 4);
+    k = 4;
+    while (k < 16000)
+    {
+        memcpy(line + k, " abcdefghijklmno", 16);
+        k += 16;
+    }
+    line[k] = '\0';
+    return (line);
+}
+
+static char *line_large_env(int i)
+{
+    char    buf[64];
+
+    if (i % 2)
+        return (strdup("/bin/true"));
+    snprintf(buf, sizeof(buf), "echo $BENCH_ENV_%d", i % LARGE_ENV_VARS);
+    return (strdup(buf));
+}
+
+static const t_workload g_workloads[] = {
+    {"builtin_loop", 0, 1, line_builtin},
+    {"external_storm", 0, 1, line_external},
+    {"var_expansion", 0, 1, line_expansion},
+    {"long_lines", 0, 4, line_long},
+    {"large_env", 1, 1, line_large_env},
+};
+
+/* Helpers ----------------------------------------------------------------- */
+
+static double now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec * 1e6 + ts.tv_nsec / 1e3);
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double  x;
+    double  y;
+
+    x = *(const double *)a;
+    y = *(const double *)b;
+    return ((x > y) - (x < y));
+}
+
+/**
+ * make_env - Build the environment for a workload
+ * @large: Add LARGE_ENV_VARS extra variables
+ *
+ * Return: NULL-terminated envp (leaked; the driver is short-lived)
+ */
+static char **make_env(int large)
+{
+    char    **envp;
+    int     n;
+    int     i;
+
+    n = 4 + (large ? LARGE_ENV_VARS : 0);
+    envp = calloc(n + 1, sizeof(char *));
+    if (!envp)
+        return (NULL);
+    envp[0] = "PATH=/usr/local/bin:/usr/bin:/bin";
+    envp[1] = "HOME=/home/bench";
+    envp[2] = "USER=bench";
+    envp[3] = "BENCH_VAR=some-value-for-expansion";
+    i = 4;
+    while (i < n)
+    {
+        if (asprintf(&envp[i], "BENCH_ENV_%d=value_%d_xxxxxxxxxxxxxxxx",
+                i - 4, i - 4) == -1)
+            return (NULL);
+        i++;
+    }
+    return (envp);
+}
+
+/* Latency run through a pseudo-terminal ----------------------------------- */
+
+/**
+ * wait_prompt - Read shell output until the prompt appears
+ * @fd: pty master (non-blocking)
+ * @pending: Bytes still to send, advanced as they are written
+ * @pending_len: Length of pending, updated
+ *
+ * Keeps writing the pending command while reading, so neither side can
+ * block on a full pty buffer.
+ *
+ * Return: 0 when the prompt was seen, -1 on timeout or EOF
+ */
+static int wait_prompt(int fd, const char **pending, size_t *pending_len)
+{
+    struct pollfd   pfd;
+    char            buf[8192];
+    char            tail[PROMPT_LEN];
+    size_t          tail_len;
+    ssize_t         n;
+    size_t          keep;
+
+    tail_len = 0;
+    while (1)
+    {
+        pfd.fd = fd;
+        pfd.events = POLLIN | (*pending_len ? POLLOUT : 0);
+        if (poll(&pfd, 1, TIMEOUT_MS) <= 0)
+            return (-1);
+        if ((pfd.revents & POLLOUT) && *pending_len)
+        {
+            n = write(fd, *pending, *pending_len);
+            if (n > 0)
+            {
+                *pending += n;
+                *pending_len -= n;
+            }
+        }
+        if (!(pfd.revents & (POLLIN | POLLHUP)))
+            continue;
+        n = read(fd, buf, sizeof(buf));
+        if (n <= 0)
+        {
+            if (n == -1 && errno == EAGAIN)
+                continue;
+            return (-1);
+        }
+        /* Keep the last PROMPT_LEN bytes printed so far */
+        if ((size_t)n >= PROMPT_LEN)
+        {
+            memcpy(tail, buf + n - PROMPT_LEN, PROMPT_LEN);
+            tail_len = PROMPT_LEN;
+        }
+        else
+        {
+            keep = tail_len;
+            if (keep + n > PROMPT_LEN)
+                keep = PROMPT_LEN - n;
+            memmove(tail, tail + tail_len - keep, keep);
+            memcpy(tail + keep, buf, n);
+            tail_len = keep + n;
+        }
+        if (*pending_len == 0 && tail_len >= PROMPT_LEN
+            && memcmp(tail + tail_len - PROMPT_LEN, PROMPT, PROMPT_LEN) == 0)
+            return (0);
+    }
+}
+
+/**
+ * run_latency - Run a workload interactively and time every command
+ * @shell: Shell binary
+ * @w: Workload
+ * @commands: Number of command lines
+ * @res: Receives timing and RSS
+ */
+static void run_latency(const char *shell, const t_workload *w, int commands,
+                        t_result *res)
+{
+    struct termios  tio;
+    struct rusage   ru;
+    double          *samples;
+    double          start;
+    double          t0;
+    const char      *pending;
+    size_t          pending_len;
+    char            *line;
+    char            *argv[2];
+    char            **envp;
+    int             master;
+    int             slave;
+    int             status;
+    int             i;
+    pid_t           pid;
+
+    res->ok = 0;
+    envp = make_env(w->large_env);
+    samples = calloc(commands, sizeof(double));
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (!envp || !samples || master == -1 || grantpt(master) == -1
+        || unlockpt(master) == -1)
+        return;
+    pid = fork();
+    if (pid == 0)
+    {
+        setsid();
+        slave = open(ptsname(master), O_RDWR);
+        if (slave == -1)
+            _exit(126);
+        /* Raw mode: no echo and no 4 KB canonical line limit */
+        tcgetattr(slave, &tio);
+        cfmakeraw(&tio);
+        tcsetattr(slave, TCSANOW, &tio);
+        dup2(slave, 0);
+        dup2(slave, 1);
+        dup2(slave, 2);
+        close(slave);
+        close(master);
+        argv[0] = (char *)shell;
+        argv[1] = NULL;
+        execve(shell, argv, envp);
+        _exit(127);
+    }
+    fcntl(master, F_SETFL, O_NONBLOCK);
+    pending_len = 0;
+    if (wait_prompt(master, &pending, &pending_len) == -1)
+        goto out;
+
+    start = now_us();
+    i = 0;
+    while (i < commands)
+    {
+        line = w->make_line(i);
+        if (!line)
+            goto out;
+        line = realloc(line, strlen(line) + 2);
+        strcat(line, "\n");
+        pending = line;
+        pending_len = strlen(line);
+        t0 = now_us();
+        if (wait_prompt(master, &pending, &pending_len) == -1)
+        {
+            free(line);
+            goto out;
+        }
+        samples[i] = now_us() - t0;
+        free(line);
+        i++;
+    }
+    res->seconds = (now_us() - start) / 1e6;
+    res->commands = commands;
+    qsort(samples, commands, sizeof(double), cmp_double);
+    res->p50_us = samples[commands / 2];
+    res->p99_us = samples[(commands * 99) / 100];
+    res->ok = 1;
+out:
+    pending = "exit\n";
+    pending_len = 5;
+    while (pending_len && write(master, pending, pending_len) == -1
+        && errno == EAGAIN)
+        usleep(1000);
+    close(master);
+    kill(pid, SIGHUP);
+    if (wait4(pid, &status, 0, &ru) == pid)
+        res->peak_rss_kb = ru.ru_maxrss;
+    free(samples);
+}
+
+/* Syscall count run under ptrace ------------------------------------------ */
+
+typedef struct s_tracee {
+    pid_t   pid;
+    int     in_syscall;
+}   t_tracee;
+
+static t_tracee *find_tracee(t_tracee *t, int *count, pid_t pid)
+{
+    int     i;
+
+    i = 0;
+    while (i < *count)
+    {
+        if (t[i].pid == pid)
+            return (&t[i]);
+        i++;
+    }
+    if (*count == MAX_TRACEES)
+    {
+        /* Reuse the slot of an exited tracee */
+        i = 0;
+        while (i < *count && t[i].pid != 0)
+            i++;
+        if (i == *count)
+            return (NULL);
+    }
+    else
+        (*count)++;
+    t[i].pid = pid;
+    t[i].in_syscall = 0;
+    return (&t[i]);
+}
+
+static void forget_tracee(t_tracee *t, int count, pid_t pid)
+{
+    int     i;
+
+    i = 0;
+    while (i < count)
+    {
+        if (t[i].pid == pid)
+            t[i].pid = 0;
+        i++;
+    }
+}
+
+/**
+ * run_syscalls - Count syscalls made while running a workload as a script
+ * @shell: Shell binary
+ * @w: Workload
+ * @commands: Number of command lines
+ * @res: Receives shell and total syscall counts
+ */
+static void run_syscalls(const char *shell, const t_workload *w, int commands,
+                         t_result *res)
+{
+    static t_tracee tracees[MAX_TRACEES];
+    t_tracee        *t;
+    char            path[] = "/tmp/minishell-bench-XXXXXX";
+    char            *argv[2];
+    char            **envp;
+    char            *line;
+    FILE            *script;
+    int             ntracees;
+    int             status;
+    int             fd;
+    int             sig;
+    int             i;
+    pid_t           shell_pid;
+    pid_t           pid;
+
+    res->shell_syscalls = -1;
+    res->total_syscalls = -1;
+    envp = make_env(w->large_env);
+    fd = mkstemp(path);
+    if (!envp || fd == -1)
+        return;
+    script = fdopen(fd, "w");
+    i = 0;
+    while (script && i < commands)
+    {
+        line = w->make_line(i++);
+        if (line)
+            fprintf(script, "%s\n", line);
+        free(line);
+    }
+    if (script)
+        fclose(script);
+
+    shell_pid = fork();
+    if (shell_pid == 0)
+    {
+        fd = open(path, O_RDONLY);
+        dup2(fd, 0);
+        fd = open("/dev/null", O_WRONLY);
+        dup2(fd, 1);
+        dup2(fd, 2);
+        ptrace(PTRACE_TRACEME, 0, NULL, NULL);
+        raise(SIGSTOP);
+        argv[0] = (char *)shell;
+        argv[1] = NULL;
+        execve(shell, argv, envp);
+        _exit(127);
+    }
+    if (waitpid(shell_pid, &status, 0) != shell_pid || !WIFSTOPPED(status)
+        || ptrace(PTRACE_SETOPTIONS, shell_pid, NULL,
+                  PTRACE_O_TRACESYSGOOD | PTRACE_O_TRACEFORK
+                  | PTRACE_O_TRACEVFORK | PTRACE_O_TRACECLONE
+                  | PTRACE_O_EXITKILL) == -1)
+    {
+        kill(shell_pid, SIGKILL);
+        waitpid(shell_pid, &status, 0);
+        unlink(path);
+        return;
+    }
+    res->shell_syscalls = 0;
+    res->total_syscalls = 0;
+    ntracees = 0;
+    ptrace(PTRACE_SYSCALL, shell_pid, NULL, NULL);
+    while ((pid = waitpid(-1, &status, __WALL)) > 0)
+    {
+        if (WIFEXITED(status) || WIFSIGNALED(status))
+        {
+            forget_tracee(tracees, ntracees, pid);
+            continue;
+        }
+        sig = 0;
+        if (WSTOPSIG(status) == (SIGTRAP | 0x80))
+        {
+            /* Count syscall entries only */
+            t = find_tracee(tracees, &ntracees, pid);
+            if (t && !t->in_syscall)
+            {
+                res->total_syscalls++;
+                if (pid == shell_pid)
+                    res->shell_syscalls++;
+            }
+            if (t)
+                t->in_syscall = !t->in_syscall;
+        }
+        else if (WSTOPSIG(status) != SIGTRAP && WSTOPSIG(status) != SIGSTOP)
+            sig = WSTOPSIG(status);
+        ptrace(PTRACE_SYSCALL, pid, NULL, (void *)(long)sig);
+    }
+    unlink(path);
+}
+
+/* Main -------------------------------------------------------------------- */
+
+static void print_result(FILE *out, const char *shell, const t_workload *w,
+                         const t_result *r, int last)
+{
+    fprintf(out, "    {\"shell\": \"%s\", \"workload\": \"%s\", ", shell,
+        w->name);
+    if (!r->ok)
+        fprintf(out, "\"ok\": false, ");
+    else
+        fprintf(out, "\"ok\": true, \"commands\": %d, "
+            "\"commands_per_sec\": %.1f, "
+            "\"latency_us\": {\"p50\": %.1f, \"p99\": %.1f}, ",
+            r->commands, r->commands / r->seconds, r->p50_us, r->p99_us);
+    fprintf(out, "\"peak_rss_kb\": %ld, "
+        "\"syscalls\": {\"shell\": %ld, \"total\": %ld}}%s\n",
+        r->peak_rss_kb, r->shell_syscalls, r->total_syscalls,
+        last ? "" : ",");
+}
+
+int main(int argc, char **argv)
+{
+    const char  *outfile;
+    FILE        *out;
+    t_result    r;
+    int         commands;
+    int         nwork;
+    int         opt;
+    int         s;
+    int         w;
+    int         n;
+
+    commands = 1000;
+    outfile = NULL;
+    while ((opt = getopt(argc, argv, "n:o:")) != -1)
+    {
+        if (opt == 'n')
+            commands = atoi(optarg);
+        else if (opt == 'o')
+            outfile = optarg;
+        else
+        {
+            fprintf(stderr, "usage: %s [-n commands] [-o file] shell...\n",
+                argv[0]);
+            return (2);
+        }
+    }
+    if (optind >= argc || commands <= 0)
+    {
+        fprintf(stderr, "usage: %s [-n commands] [-o file] shell...\n",
+            argv[0]);
+        return (2);
+    }
+    out = stdout;
+    if (outfile && !(out = fopen(outfile, "w")))
+    {
+        perror(outfile);
+        return (1);
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    nwork = sizeof(g_workloads) / sizeof(g_workloads[0]);
+    fprintf(out, "{\n  \"commands\": %d,\n  \"results\": [\n", commands);
+    s = optind;
+    while (s < argc)
+    {
+        w = 0;
+        while (w < nwork)
+        {
+            memset(&r, 0, sizeof(r));
+            n = commands / g_workloads[w].divisor;
+            fprintf(stderr, "bench: %s %s...\n", argv[s], g_workloads[w].name);
+            run_latency(argv[s], &g_workloads[w], n, &r);
+            run_syscalls(argv[s], &g_workloads[w], n, &r);
+            print_result(out, argv[s], &g_workloads[w], &r,
+                s == argc - 1 && w == nwork - 1);
+            w++;
+        }
+        s++;
+    }
+    fprintf(out, "  ]\n}\n");
+    if (out != stdout)
+        fclose(out);
+    return (0);
+}
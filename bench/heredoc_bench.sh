@@ -0,0 +1,55 @@
+#!/bin/sh
+# heredoc_bench.sh - Measure here-document throughput of minishell
+# Usage: bench/heredoc_bench.sh [minishell binary]
+#
+# Runs 'wc -c <<EOF' on bodies of 1 KB, 1 MB, 10 MB and 100 MB, once with
+# a quoted delimiter (body taken literally) and once with one $VAR per
+# line to expand, and prints one line per run with the throughput in
+# MB/s. The body is read from a script file, so the time covers reading,
+# expansion and handing the body to the child.
+
+SHELL_BIN=${1:-./minishell}
+TMP=$(mktemp -d) || exit 1
+trap 'rm -rf "$TMP"' EXIT
+
+now_ns() {
+    date +%s%N
+}
+
+# make_script KB DELIM LINE: a script feeding KB kilobytes of LINE to wc -c
+make_script() {
+    kb=$1
+    delim=$2
+    line=$3
+    {
+        echo "export V=$(printf '%063d' 1)"
+        echo "wc -c <<$delim"
+        awk -v n=$((kb * 16)) -v l="$line" 'BEGIN { for (i = 0; i < n; i++) print l }'
+        echo "EOF"
+    } > "$TMP/script"
+}
+
+run() {
+    kb=$1
+    mode=$2
+    if [ "$mode" = literal ]; then
+        make_script "$kb" "'EOF'" "$(printf '%063d' 0)"
+    else
+        make_script "$kb" "EOF" '$V'
+    fi
+    start=$(now_ns)
+    out=$("$SHELL_BIN" "$TMP/script" 2>&1 | tr -cd '0-9')
+    end=$(now_ns)
+    if [ "$out" != "$((kb * 1024))" ]; then
+        echo "size=${kb}KB mode=$mode FAILED (got '$out')"
+        return
+    fi
+    echo "$kb $((end - start))" | awk -v mode="$mode" \
+        '{ printf "size=%dKB mode=%s time=%.3fs throughput=%.1f MB/s\n", $1,
+           mode, $2 / 1e9, $1 / 1024 / ($2 / 1e9) }'
+}
+
+for kb in 1 1024 10240 102400; do
+    run "$kb" literal
+    run "$kb" expand
+done
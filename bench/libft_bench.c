@@ -0,0 +1,408 @@
+/* libft_bench.c - Differential check and microbenchmark for libft kernels */
+/* Author: your_login */
+
+/*
+ * Usage: libft_bench [-q]
+ *
+ * First checks every kernel level this CPU supports (see libft_simd.c)
+ * against byte-at-a-time reference copies of the original libft loops:
+ * random strings of every length up to a few hundred bytes, at every
+ * alignment, placed both in the middle of a page and flush against an
+ * unmapped guard page so that any read past a page boundary faults.
+ * A mismatch prints the case and exits 1.
+ *
+ * Then times each level and the reference on a few string sizes and
+ * prints ns per call. -q skips the timing. Built with the shell's own
+ * CFLAGS, so the reference numbers are what the old loops cost.
+ */
+
+#define _GNU_SOURCE
+#include "../minishell.h"
+#include <stdint.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#define MAX_LEN     300
+#define MAX_OFFSET  40
+#define BENCH_BYTES (16UL << 20)
+
+typedef struct s_region {
+    char    *base;      // guard page, then usable pages, then guard page
+    char    *mid;       // start of the usable pages
+    char    *end;       // first byte of the trailing guard page
+    size_t  page;
+}   t_region;
+
+static unsigned long    g_seed = 88172645463325252UL;
+static volatile size_t  g_sink;
+
+static unsigned long    next_random(void)
+{
+    g_seed ^= g_seed << 13;
+    g_seed ^= g_seed >> 7;
+    g_seed ^= g_seed << 17;
+    return (g_seed);
+}
+
+/* Reference implementations: the original byte loops */
+
+static size_t   ref_strlen(const char *s)
+{
+    size_t  len;
+
+    len = 0;
+    while (s[len])
+        len++;
+    return (len);
+}
+
+static char *ref_strchr(const char *s, int c)
+{
+    size_t  i;
+    size_t  len;
+
+    len = ref_strlen(s);
+    i = 0;
+    while (i <= len)
+    {
+        if (s[i] == (char)c)
+            return ((char *)&s[i]);
+        i++;
+    }
+    return (NULL);
+}
+
+static int  ref_strncmp(const char *s1, const char *s2, size_t n)
+{
+    size_t  i;
+
+    i = 0;
+    while (i < n && s1[i] && s2[i])
+    {
+        if (s1[i] != s2[i])
+            return ((unsigned char)s1[i] - (unsigned char)s2[i]);
+        i++;
+    }
+    if (i == n)
+        return (0);
+    return ((unsigned char)s1[i] - (unsigned char)s2[i]);
+}
+
+static void ref_memset(void *b, int c, size_t len)
+{
+    size_t          i;
+    unsigned char   *ptr;
+
+    ptr = (unsigned char *)b;
+    i = 0;
+    while (i < len)
+    {
+        ptr[i] = (unsigned char)c;
+        i++;
+    }
+}
+
+static size_t   ref_count_words(const char *str, char delim)
+{
+    size_t  count;
+    size_t  i;
+    int     in_word;
+
+    count = 0;
+    i = 0;
+    in_word = 0;
+    while (str[i])
+    {
+        if (str[i] != delim && !in_word)
+        {
+            in_word = 1;
+            count++;
+        }
+        else if (str[i] == delim)
+            in_word = 0;
+        i++;
+    }
+    return (count);
+}
+
+static const t_simd_ops g_ref_ops = {
+    "scalar", ref_strlen, ref_strchr, ref_strncmp, ref_memset,
+    ref_count_words
+};
+
+/* Differential check */
+
+static int  region_init(t_region *r, size_t pages)
+{
+    r->page = (size_t)sysconf(_SC_PAGESIZE);
+    r->base = mmap(NULL, (pages + 2) * r->page, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (r->base == MAP_FAILED)
+        return (-1);
+    r->mid = r->base + r->page;
+    r->end = r->mid + pages * r->page;
+    if (mprotect(r->base, r->page, PROT_NONE) == -1
+        || mprotect(r->end, r->page, PROT_NONE) == -1)
+        return (-1);
+    return (0);
+}
+
+/**
+ * fill_string - Write a random NUL-terminated string
+ * @dst: Where to write len + 1 bytes
+ * @len: String length
+ * @delim_every: Make roughly one byte in this many a space (0 = none)
+ */
+static void fill_string(char *dst, size_t len, int delim_every)
+{
+    size_t  i;
+
+    i = 0;
+    while (i < len)
+    {
+        dst[i] = (char)(next_random() % 255 + 1);
+        if (delim_every && next_random() % delim_every == 0)
+            dst[i] = ' ';
+        i++;
+    }
+    dst[len] = '\0';
+}
+
+static int  fail(const char *what, const char *level, size_t len,
+                 size_t off, long got, long want)
+{
+    fprintf(stderr, "libft_bench: %s mismatch (%s, len %zu, offset %zu):"
+            " got %ld, want %ld\n", what, level, len, off, got, want);
+    return (-1);
+}
+
+/**
+ * check_string - Compare the read-only kernels on one string
+ * @s: String to test, possibly ending at a guard page
+ * @other: Scratch space for a second string (len + 1 bytes)
+ * @len: Length of s
+ * @off: Alignment offset, for error messages
+ *
+ * Return: 0 if all agree, -1 on the first mismatch
+ */
+static int  check_string(const char *s, char *other, size_t len, size_t off)
+{
+    const char  *level;
+    int         cs[6];
+    size_t      n;
+    size_t      k;
+    int         i;
+
+    level = SIMD_OPS()->name;
+    if (ft_strlen(s) != len)
+        return (fail("ft_strlen", level, len, off, ft_strlen(s), len));
+    cs[0] = 0;
+    cs[1] = ' ';
+    cs[2] = 0x80;
+    cs[3] = 'a' + 256;
+    cs[4] = len ? (unsigned char)s[next_random() % len] : 'x';
+    cs[5] = len ? (unsigned char)s[len - 1] : 'y';
+    i = 0;
+    while (i < 6)
+    {
+        if (ft_strchr(s, cs[i]) != ref_strchr(s, cs[i]))
+            return (fail("ft_strchr", level, len, off,
+                         (long)ft_strchr(s, cs[i]), (long)ref_strchr(s, cs[i])));
+        i++;
+    }
+    if (SIMD_OPS()->count_words(s, ' ') != ref_count_words(s, ' '))
+        return (fail("count_words", level, len, off,
+                     SIMD_OPS()->count_words(s, ' '),
+                     ref_count_words(s, ' ')));
+    if (SIMD_OPS()->count_words(s, '\0') != ref_count_words(s, '\0'))
+        return (fail("count_words(NUL)", level, len, off,
+                     SIMD_OPS()->count_words(s, '\0'),
+                     ref_count_words(s, '\0')));
+
+    /* Equal copy, then one byte changed; various n around the change */
+    memcpy(other, s, len + 1);
+    k = len ? next_random() % (len + 1) : 0;
+    if (k < len && next_random() % 2)
+        other[k] = (char)(other[k] ^ (1 << (next_random() % 8)));
+    else if (k < len)
+        other[k] = '\0';
+    n = 0;
+    while (n <= len + 2)
+    {
+        if (ft_strncmp(s, other, n) != ref_strncmp(s, other, n)
+            || ft_strncmp(other, s, n) != ref_strncmp(other, s, n))
+            return (fail("ft_strncmp", level, len, off,
+                         ft_strncmp(s, other, n), ref_strncmp(s, other, n)));
+        n += 1 + (len > 64) * (next_random() % 16);
+    }
+    if (ft_strncmp(s, other, (size_t)-1) != ref_strncmp(s, other, (size_t)-1))
+        return (fail("ft_strncmp(SIZE_MAX)", level, len, off,
+                     ft_strncmp(s, other, (size_t)-1),
+                     ref_strncmp(s, other, (size_t)-1)));
+    return (0);
+}
+
+/**
+ * check_memset - Compare ft_memset and ft_strlcpy with the references
+ * @r: Scratch region
+ * @len: Fill length
+ * @off: Destination alignment
+ *
+ * Return: 0 if all agree, -1 on the first mismatch
+ */
+static int  check_memset(t_region *r, size_t len, size_t off)
+{
+    char    *a;
+    char    *b;
+    char    src[MAX_LEN + 1];
+    size_t  size;
+    size_t  copy;
+    int     c;
+
+    a = r->mid;
+    b = r->mid + 2 * (MAX_LEN + MAX_OFFSET);
+    memset(a, 0x5a, MAX_LEN + MAX_OFFSET + 8);
+    memset(b, 0x5a, MAX_LEN + MAX_OFFSET + 8);
+    c = (int)(next_random() % 512) - 128;
+    ft_memset(a + off, c, len);
+    ref_memset(b + off, c, len);
+    if (memcmp(a, b, MAX_LEN + MAX_OFFSET + 8) != 0)
+        return (fail("ft_memset", SIMD_OPS()->name, len, off, c, c));
+    fill_string(src, len, 0);
+    size = next_random() % (len + 2);
+    copy = len;
+    if (size && copy > size - 1)
+        copy = size - 1;
+    if (ft_strlcpy(a + off, src, size) != len
+        || (size && (memcmp(a + off, src, copy) != 0 || a[off + copy])))
+        return (fail("ft_strlcpy", SIMD_OPS()->name, len, off, size, len));
+    return (0);
+}
+
+static int  run_checks(t_region *r)
+{
+    char    *s;
+    size_t  len;
+    size_t  off;
+    long    cases;
+
+    cases = 0;
+    len = 0;
+    while (len <= MAX_LEN)
+    {
+        off = 0;
+        while (off < MAX_OFFSET)
+        {
+            /* Middle of the region, then flush against the guard page */
+            s = r->mid + 4 * (MAX_LEN + MAX_OFFSET) + off;
+            fill_string(s, len, 1 + (int)(len % 5));
+            if (check_string(s, r->mid + 8 * (MAX_LEN + MAX_OFFSET) + off / 3,
+                             len, off) == -1)
+                return (-1);
+            s = r->end - len - 1 - off % 8;
+            fill_string(s, len, (int)(off % 4));
+            if (check_string(s, r->end - 2 * (MAX_LEN + MAX_OFFSET) - off,
+                             len, off) == -1)
+                return (-1);
+            if (check_memset(r, len, off) == -1)
+                return (-1);
+            cases += 3;
+            off++;
+        }
+        len++;
+    }
+    return ((int)(cases > 0 ? 0 : -1));
+}
+
+/* Microbenchmark */
+
+static double   now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec * 1e9 + ts.tv_nsec);
+}
+
+static void bench_ops(const t_simd_ops *ops, char *a, char *b, size_t size)
+{
+    size_t  iters;
+    size_t  i;
+    double  t[5];
+
+    iters = BENCH_BYTES / size;
+    t[0] = now_ns();
+    for (i = 0; i < iters; i++)
+        g_sink += ops->len(a + (i & 1));
+    t[0] = (now_ns() - t[0]) / iters;
+    t[1] = now_ns();
+    for (i = 0; i < iters; i++)
+        g_sink += (size_t)ops->chr(a, '\x01');
+    t[1] = (now_ns() - t[1]) / iters;
+    t[2] = now_ns();
+    for (i = 0; i < iters; i++)
+        g_sink += ops->ncmp(a, b, size);
+    t[2] = (now_ns() - t[2]) / iters;
+    t[3] = now_ns();
+    for (i = 0; i < iters; i++)
+        ops->set(b + size + 64, (int)i, size);
+    t[3] = (now_ns() - t[3]) / iters;
+    t[4] = now_ns();
+    for (i = 0; i < iters; i++)
+        g_sink += ops->count_words(a, ' ');
+    t[4] = (now_ns() - t[4]) / iters;
+    printf("%-7s %6zu %10.1f %10.1f %10.1f %10.1f %10.1f\n", ops->name,
+           size, t[0], t[1], t[2], t[3], t[4]);
+}
+
+static void run_bench(t_region *r)
+{
+    static const size_t sizes[] = {8, 32, 256, 4096};
+    char                *a;
+    char                *b;
+    size_t              i;
+    int                 level;
+
+    printf("%-7s %6s %10s %10s %10s %10s %10s   (ns/call)\n", "kernels",
+           "bytes", "strlen", "strchr", "strncmp", "memset", "split");
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        a = r->mid;
+        b = r->mid + 2 * sizes[i] + 64;
+        fill_string(a, sizes[i], 6);
+        memcpy(b, a, sizes[i] + 1);
+        bench_ops(&g_ref_ops, a, b, sizes[i]);
+        for (level = 0; level < SIMD_LEVEL_COUNT; level++)
+        {
+            if (simd_select(level) == -1)
+                continue;
+            bench_ops(g_global.simd, a, b, sizes[i]);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    t_region    r;
+    int         level;
+
+    if (region_init(&r, 8) == -1)
+    {
+        perror("libft_bench: mmap");
+        return (1);
+    }
+    for (level = 0; level < SIMD_LEVEL_COUNT; level++)
+    {
+        if (simd_select(level) == -1)
+        {
+            printf("libft check: level %d not supported, skipped\n", level);
+            continue;
+        }
+        if (run_checks(&r) == -1)
+            return (1);
+        printf("libft check: %s ok\n", g_global.simd->name);
+    }
+    if (argc < 2 || strcmp(argv[1], "-q") != 0)
+        run_bench(&r);
+    return (0);
+}
@@ -0,0 +1,42 @@
+#!/bin/sh
+# pipeline_bench.sh - Measure pipeline throughput of minishell
+# Usage: bench/pipeline_bench.sh [minishell binary] [megabytes]
+#
+# Pushes MB megabytes of zeros through pipelines of 2, 4 and 8 stages,
+# once with the default pipe capacity and once with --pipe-size=1048576,
+# and prints one line per run with the throughput in MB/s.
+
+SHELL_BIN=${1:-./minishell}
+MB=${2:-512}
+BYTES=$((MB * 1048576))
+
+now_ns() {
+    date +%s%N
+}
+
+run() {
+    stages=$1
+    opts=$2
+    line="head -c $BYTES /dev/zero"
+    i=2
+    while [ "$i" -lt "$stages" ]; do
+        line="$line | cat"
+        i=$((i + 1))
+    done
+    line="$line | wc -c"
+    start=$(now_ns)
+    out=$(echo "$line" | "$SHELL_BIN" $opts 2>&1 | tr -cd '0-9\n' | grep -x "$BYTES")
+    end=$(now_ns)
+    if [ -z "$out" ]; then
+        echo "stages=$stages opts='$opts' FAILED"
+        return
+    fi
+    echo "$stages $((end - start)) $MB" | awk -v opts="$opts" \
+        '{ printf "stages=%d pipe=%s time=%.3fs throughput=%.1f MB/s\n", $1,
+           (opts == "" ? "default" : opts), $2 / 1e9, $3 / ($2 / 1e9) }'
+}
+
+for stages in 2 4 8; do
+    run "$stages" ""
+    run "$stages" "--pipe-size=1048576"
+done
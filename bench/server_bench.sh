@@ -0,0 +1,72 @@
+#!/bin/sh
+# server_bench.sh - Compare cold minishell runs with a warm command server
+# Usage: bench/server_bench.sh [minishell binary] [runs]
+#
+# Runs the same short command line N times (default 200), first as
+# 'minishell -c CMD' (a fresh shell each time) and then as
+# 'minishell --client SOCK -c CMD' against one 'minishell --server SOCK'.
+# Prints the total and per-run time of both and the speedup; output of
+# the commands themselves goes to /dev/null.
+#
+# BENCH_CMD overrides the command line. BENCH_ENV_VARS=N adds N 100-byte
+# variables and BENCH_PATH_DIRS=N puts N missing directories in front of
+# PATH, to model tooling that runs with a large environment.
+
+SHELL_BIN=${1:-./minishell}
+RUNS=${2:-200}
+TMP=$(mktemp -d) || exit 1
+SOCK="$TMP/sock"
+CMD=${BENCH_CMD:-'echo bench | cat'}
+SERVER_PID=
+
+i=0
+while [ "$i" -lt "${BENCH_ENV_VARS:-0}" ]; do
+    export "BENCH_VAR_$i=$(printf '%0100d' "$i")"
+    i=$((i + 1))
+done
+i=0
+while [ "$i" -lt "${BENCH_PATH_DIRS:-0}" ]; do
+    PATH="$TMP/missing$i:$PATH"
+    i=$((i + 1))
+done
+export PATH
+
+cleanup() {
+    [ -n "$SERVER_PID" ] && kill "$SERVER_PID" 2>/dev/null
+    rm -rf "$TMP"
+}
+trap cleanup EXIT
+
+now_ns() {
+    date +%s%N
+}
+
+# time_runs ARGS...: run the shell RUNS times with ARGS, print elapsed ns
+time_runs() {
+    start=$(now_ns)
+    i=0
+    while [ "$i" -lt "$RUNS" ]; do
+        "$SHELL_BIN" "$@" > /dev/null || echo "run $i failed" >&2
+        i=$((i + 1))
+    done
+    end=$(now_ns)
+    echo $((end - start))
+}
+
+report() {
+    echo "$1 $2" | awk -v n="$RUNS" -v mode="$3" \
+        '{ printf "mode=%-6s runs=%d total=%.3fs per-run=%.1fus\n", mode, n,
+           $1 / 1e9, $1 / 1e3 / n }'
+}
+
+"$SHELL_BIN" --server "$SOCK" &
+SERVER_PID=$!
+while [ ! -S "$SOCK" ]; do
+    sleep 0.01
+done
+
+cold=$(time_runs -c "$CMD")
+warm=$(time_runs --client "$SOCK" -c "$CMD")
+report "$cold" "$RUNS" cold
+report "$warm" "$RUNS" server
+echo "$cold $warm" | awk '{ printf "speedup=%.2fx\n", $1 / $2 }'
@@ -0,0 +1,45 @@
+#!/bin/sh
+# spawn_bench.sh - Compare process launch backends of minishell
+# Usage: bench/spawn_bench.sh [minishell binary] [commands] [heap MB...]
+#
+# For each heap size (default "0 64 256"), first grows the shell's heap
+# by about that many megabytes (one long line keeps the arena and
+# expansion buffer that large), then runs COMMANDS invocations of
+# /bin/true through each --spawn backend and prints commands per second
+# and the latency per command. The commands are timed from inside the
+# script, by /bin/date before and after them, so growing the heap is not
+# counted. fork slows down as the heap grows; the others should stay
+# flat.
+
+SHELL_BIN=${1:-./minishell}
+COUNT=${2:-2000}
+shift 2 2>/dev/null
+HEAP_SIZES=${*:-0 64 256}
+SCRIPT=$(mktemp)
+trap 'rm -f "$SCRIPT"' EXIT
+
+for heap in $HEAP_SIZES; do
+    # Half of the growth lands in the arena, half in the expansion buffer
+    {
+        printf 'echo '
+        head -c $((heap * 524288)) /dev/zero | tr '\0' 'x'
+        echo ' > /dev/null'
+        echo '/bin/date +%s%N'
+        i=0
+        while [ "$i" -lt "$COUNT" ]; do
+            echo "/bin/true"
+            i=$((i + 1))
+        done
+        echo '/bin/date +%s%N'
+    } > "$SCRIPT"
+
+    for backend in fork vfork posix_spawn helper; do
+        "$SHELL_BIN" --spawn=$backend < "$SCRIPT" | awk -v heap="$heap" \
+            -v backend="$backend" -v n="$COUNT" \
+            'NR == 1 { start = $1 } NR == 2 {
+               t = ($1 - start) / 1e9
+               printf "heap=%dMB backend=%-11s time=%.3fs " \
+                   "commands_per_sec=%.0f per_command=%.1fus\n", heap,
+                   backend, t, n / t, t * 1e6 / n }'
+    done
+done
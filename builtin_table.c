@@ -0,0 +1,198 @@
+/* builtin_table.c - Builtin registry and dispatch for Minishell */
+/* Author: your_login */
+
+#include "minishell.h"
+
+/*
+ * Every builtin is registered once in g_builtins with its handler and
+ * flags. find_builtin resolves a name with a switch on its first
+ * characters and a single ft_strcmp, so adding a builtin means adding a
+ * table row and a case below.
+ *
+ * Flags:
+ *   BUILTIN_PARENT     changes shell state, so it only has an effect when
+ *                      run in the shell process itself
+ *   BUILTIN_PIPE_SAFE  only reads state and writes output, so it may run
+ *                      as a pipeline stage or in-process with its output
+ *                      captured
+ */
+
+static int  run_echo(t_cmd *cmd, t_env *env)
+{
+    (void)env;
+    return (ft_echo(cmd->argv, cmd->argc));
+}
+
+static int  run_cd(t_cmd *cmd, t_env *env)
+{
+    (void)env;
+    return (ft_cd(cmd->argv, cmd->argc));
+}
+
+static int  run_pwd(t_cmd *cmd, t_env *env)
+{
+    (void)cmd;
+    (void)env;
+    return (ft_pwd());
+}
+
+static int  run_export(t_cmd *cmd, t_env *env)
+{
+    return (ft_export(cmd->argv, cmd->argc, env));
+}
+
+static int  run_unset(t_cmd *cmd, t_env *env)
+{
+    return (ft_unset(cmd->argv, cmd->argc, env));
+}
+
+static int  run_env(t_cmd *cmd, t_env *env)
+{
+    (void)cmd;
+    return (ft_env(env));
+}
+
+static int  run_exit(t_cmd *cmd, t_env *env)
+{
+    (void)env;
+    return (ft_exit(cmd->argv, cmd->argc));
+}
+
+static int  run_hash(t_cmd *cmd, t_env *env)
+{
+    return (ft_hash(cmd->argv, cmd->argc, env));
+}
+
+static int  run_jobs(t_cmd *cmd, t_env *env)
+{
+    (void)cmd;
+    (void)env;
+    return (ft_jobs());
+}
+
+static int  run_parallel(t_cmd *cmd, t_env *env)
+{
+    return (ft_parallel(cmd, env));
+}
+
+static int  run_shellstats(t_cmd *cmd, t_env *env)
+{
+    (void)env;
+    return (ft_shellstats(cmd->argv, cmd->argc));
+}
+
+static int  run_times(t_cmd *cmd, t_env *env)
+{
+    (void)env;
+    return (ft_times(cmd->argv, cmd->argc));
+}
+
+static int  run_wait(t_cmd *cmd, t_env *env)
+{
+    (void)env;
+    return (ft_wait(cmd->argv, cmd->argc));
+}
+
+enum e_builtin_id {
+    BI_CD,
+    BI_ECHO,
+    BI_ENV,
+    BI_EXIT,
+    BI_EXPORT,
+    BI_HASH,
+    BI_JOBS,
+    BI_PARALLEL,
+    BI_PWD,
+    BI_SHELLSTATS,
+    BI_TIMES,
+    BI_UNSET,
+    BI_WAIT
+};
+
+static const t_builtin  g_builtins[] = {
+    [BI_CD] = {"cd", run_cd, BUILTIN_PARENT},
+    [BI_ECHO] = {"echo", run_echo, BUILTIN_PIPE_SAFE},
+    [BI_ENV] = {"env", run_env, BUILTIN_PIPE_SAFE},
+    [BI_EXIT] = {"exit", run_exit, BUILTIN_PARENT},
+    [BI_EXPORT] = {"export", run_export, BUILTIN_PARENT},
+    [BI_HASH] = {"hash", run_hash, BUILTIN_PARENT},
+    [BI_JOBS] = {"jobs", run_jobs, BUILTIN_PARENT},
+    [BI_PARALLEL] = {"parallel", run_parallel, 0},
+    [BI_PWD] = {"pwd", run_pwd, BUILTIN_PIPE_SAFE},
+    [BI_SHELLSTATS] = {"shellstats", run_shellstats, BUILTIN_PIPE_SAFE},
+    [BI_TIMES] = {"times", run_times, BUILTIN_PIPE_SAFE},
+    [BI_UNSET] = {"unset", run_unset, BUILTIN_PARENT},
+    [BI_WAIT] = {"wait", run_wait, BUILTIN_PARENT},
+};
+
+/**
+ * builtin_candidate - Pick the only builtin a name could be
+ * @name: Command name (non-empty)
+ *
+ * Return: Index into g_builtins, or -1 if no builtin starts this way
+ */
+static int builtin_candidate(const char *name)
+{
+    switch (name[0])
+    {
+        case 'c':
+            return (BI_CD);
+        case 'e':
+            if (name[1] == 'c')
+                return (BI_ECHO);
+            if (name[1] == 'n')
+                return (BI_ENV);
+            if (name[1] == 'x' && name[2] == 'i')
+                return (BI_EXIT);
+            if (name[1] == 'x')
+                return (BI_EXPORT);
+            return (-1);
+        case 'h':
+            return (BI_HASH);
+        case 'j':
+            return (BI_JOBS);
+        case 'p':
+            if (name[1] == 'a')
+                return (BI_PARALLEL);
+            return (BI_PWD);
+        case 's':
+            return (BI_SHELLSTATS);
+        case 't':
+            return (BI_TIMES);
+        case 'u':
+            return (BI_UNSET);
+        case 'w':
+            return (BI_WAIT);
+        default:
+            return (-1);
+    }
+}
+
+/**
+ * find_builtin - Look up a builtin by name
+ * @name: Command name
+ *
+ * Return: Registry entry, or NULL if name is not a builtin
+ */
+const t_builtin *find_builtin(const char *name)
+{
+    int     id;
+    
+    if (!name || !name[0])
+        return (NULL);
+    id = builtin_candidate(name);
+    if (id < 0 || ft_strcmp(name, g_builtins[id].name) != 0)
+        return (NULL);
+    return (&g_builtins[id]);
+}
+
+/**
+ * is_builtin - Check if command is a builtin
+ * @cmd: Command to check
+ *
+ * Return: 1 if builtin, 0 otherwise
+ */
+int     is_builtin(char *cmd)
+{
+    return (find_builtin(cmd) != NULL);
+}
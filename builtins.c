@@ -4,27 +4,6 @@
 #include "minishell.h"
 #include <limits.h>
 
-/**
- * is_builtin - Check if command is a builtin
- * @cmd: Command to check
- *
- * Return: 1 if builtin, 0 otherwise
- */
-int     is_builtin(char *cmd)
-{
-    if (!cmd)
-        return (0);
-    if (ft_strcmp(cmd, "echo") == 0 ||
-        ft_strcmp(cmd, "cd") == 0 ||
-        ft_strcmp(cmd, "pwd") == 0 ||
-        ft_strcmp(cmd, "export") == 0 ||
-        ft_strcmp(cmd, "unset") == 0 ||
-        ft_strcmp(cmd, "env") == 0 ||
-        ft_strcmp(cmd, "exit") == 0)
-        return (1);
-    return (0);
-}
-
 /**
  * ft_echo - Implement echo builtin
  * @argv: Command arguments
@@ -47,20 +26,20 @@ int     ft_echo(char **argv, int argc)
         i = 2;
     }
     
-    /* Print arguments */
+    /* Queue arguments; written with one syscall below */
     while (i < argc)
     {
-        printf("%s", argv[i]);
+        out_str(&g_global.out, argv[i]);
         if (i < argc - 1)
-            printf(" ");
+            out_putc(&g_global.out, ' ');
         i++;
     }
     
     if (newline)
-        printf("\n");
+        out_putc(&g_global.out, '\n');
     
-    g_global.exit_status = 0;
-    return (0);
+    g_global.exit_status = builtin_flush("echo");
+    return (g_global.exit_status);
 }
 
 /**
@@ -85,7 +64,7 @@ int     ft_cd(char **argv, int argc)
     if (argc == 1)
     {
         /* cd without arguments - go to HOME */
-        home = getenv("HOME");
+        home = get_env_value("HOME", &g_global.env);
         if (!home)
         {
             fprintf(stderr, "cd: HOME not set\n");
@@ -134,22 +113,24 @@ int     ft_pwd(void)
         return (1);
     }
     
-    printf("%s\n", cwd);
+    out_str(&g_global.out, cwd);
+    out_putc(&g_global.out, '\n');
+    g_global.exit_status = builtin_flush("pwd");
     free(cwd);
-    g_global.exit_status = 0;
-    return (0);
+    return (g_global.exit_status);
 }
 
 /**
  * ft_export - Implement export builtin
  * @argv: Command arguments
  * @argc: Argument count
- * @env: Environment variable array
+ * @env: Environment store
  *
  * Return: 0 on success
  */
-int     ft_export(char **argv, int argc, char ***env)
+int     ft_export(char **argv, int argc, t_env *env)
 {
+    size_t  j;
     int     i;
     char    *key;
     char    *value;
@@ -157,14 +138,16 @@ int     ft_export(char **argv, int argc, char ***env)
     if (argc == 1)
     {
         /* Display all environment variables */
-        i = 0;
-        while ((*env)[i])
+        j = 0;
+        while (j < env->count)
         {
-            printf("declare -x %s\n", (*env)[i]);
-            i++;
+            out_write(&g_global.out, "declare -x ", 11);
+            out_str(&g_global.out, env->vars[j].str);
+            out_putc(&g_global.out, '\n');
+            j++;
         }
-        g_global.exit_status = 0;
-        return (0);
+        g_global.exit_status = builtin_flush("export");
+        return (g_global.exit_status);
     }
     
     i = 1;
@@ -191,67 +174,20 @@ int     ft_export(char **argv, int argc, char ***env)
  * ft_unset - Implement unset builtin
  * @argv: Command arguments
  * @argc: Argument count
- * @env: Environment variable array
+ * @env: Environment store
  *
  * Return: 0 on success
  */
-int     ft_unset(char **argv, int argc, char ***env)
+int     ft_unset(char **argv, int argc, t_env *env)
 {
     int     i;
-    int     j;
-    size_t  env_size;
-    char    **new_env;
     
-    if (argc == 1)
-    {
-        g_global.exit_status = 0;
-        return (0);
-    }
-    
-    /* Count environment variables */
-    env_size = 0;
-    while ((*env)[env_size])
-        env_size++;
-    
-    /* Create new environment without specified variables */
-    new_env = malloc((env_size + 1) * sizeof(char *));
-    if (!new_env)
-    {
-        g_global.exit_status = 1;
-        return (1);
-    }
-    
-    i = 0;
-    j = 0;
-    while ((*env)[i])
+    i = 1;
+    while (i < argc)
     {
-        int should_skip = 0;
-        int k = 1;
-        
-        while (k < argc)
-        {
-            if (ft_strcmp((*env)[i], argv[k]) == 0)
-            {
-                should_skip = 1;
-                break;
-            }
-            k++;
-        }
-        
-        if (!should_skip)
-        {
-            new_env[j++] = (*env)[i];
-        }
-        else
-        {
-            free((*env)[i]);
-        }
+        unset_env_value(argv[i], env);
         i++;
     }
-    new_env[j] = NULL;
-    
-    free(*env);
-    *env = new_env;
     
     g_global.exit_status = 0;
     return (0);
@@ -259,23 +195,24 @@ int     ft_unset(char **argv, int argc, char ***env)
 
 /**
  * ft_env - Implement env builtin
- * @env: Environment variable array
+ * @env: Environment store
  *
  * Return: 0 on success
  */
-int     ft_env(char **env)
+int     ft_env(t_env *env)
 {
-    int     i;
+    size_t  i;
     
     i = 0;
-    while (env[i])
+    while (i < env->count)
     {
-        printf("%s\n", env[i]);
+        out_str(&g_global.out, env->vars[i].str);
+        out_putc(&g_global.out, '\n');
         i++;
     }
     
-    g_global.exit_status = 0;
-    return (0);
+    g_global.exit_status = builtin_flush("env");
+    return (g_global.exit_status);
 }
 
 /**
@@ -305,7 +242,9 @@ int     ft_exit(char **argv, int argc)
         exit_code = ft_atoi(argv[1]);
     }
     
-    printf("exit\n");
+    if (g_global.interactive)
+        write(STDERR_FILENO, "exit\n", 5);
+    g_global.exit_status = exit_code;   /* seen by atexit handlers */
     exit(exit_code);
     return (0);  /* This line never reached */
 }
\ No newline at end of file
@@ -0,0 +1,342 @@
+/* env_store.c - Hash-indexed environment store for Minishell */
+/* Author: your_login */
+
+#include "minishell.h"
+
+#define ENV_SLOT_EMPTY      -1
+#define ENV_SLOT_DELETED    -2
+#define ENV_MIN_SLOTS       64
+
+/*
+ * Variables live in a dense array (t_env.vars) so they can be listed and
+ * handed to execve cheaply. An open-addressing table of indices into that
+ * array (t_env.slots) gives O(1) lookup, insert and delete. Deleting moves
+ * the last variable into the hole, so the dense array never has gaps.
+ */
+
+/**
+ * env_find_slot - Find the slot holding a key
+ * @env: Environment store
+ * @key: Variable name (not necessarily NUL-terminated)
+ * @key_len: Length of the name
+ * @hash: Hash of the name
+ *
+ * Return: Slot index, or -1 if the key is not present
+ */
+static long env_find_slot(t_env *env, const char *key, size_t key_len,
+                          unsigned int hash)
+{
+    size_t      mask;
+    size_t      i;
+    int         idx;
+    t_env_var   *var;
+    
+    if (!env->slots)
+        return (-1);
+    mask = env->slot_cap - 1;
+    i = hash & mask;
+    while (env->slots[i] != ENV_SLOT_EMPTY)
+    {
+        idx = env->slots[i];
+        if (idx >= 0)
+        {
+            var = &env->vars[idx];
+            if (var->hash == hash && var->key_len == key_len
+                && ft_strncmp(var->str, key, key_len) == 0)
+                return ((long)i);
+        }
+        i = (i + 1) & mask;
+    }
+    return (-1);
+}
+
+/**
+ * env_place - Put a variable index into the first free slot for its hash
+ * @env: Environment store
+ * @hash: Hash of the variable name
+ * @idx: Index into env->vars
+ */
+static void env_place(t_env *env, unsigned int hash, int idx)
+{
+    size_t  mask;
+    size_t  i;
+    
+    mask = env->slot_cap - 1;
+    i = hash & mask;
+    while (env->slots[i] >= 0)
+        i = (i + 1) & mask;
+    if (env->slots[i] == ENV_SLOT_EMPTY)
+        env->slot_used++;
+    env->slots[i] = idx;
+}
+
+/**
+ * env_rehash - Rebuild the slot table, dropping deleted markers
+ * @env: Environment store
+ * @slot_cap: New slot table size (power of two)
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+static int env_rehash(t_env *env, size_t slot_cap)
+{
+    int     *slots;
+    size_t  i;
+    
+    slots = malloc(slot_cap * sizeof(int));
+    if (!slots)
+        return (-1);
+    ft_memset(slots, 0xff, slot_cap * sizeof(int));  /* ENV_SLOT_EMPTY */
+    free(env->slots);
+    env->slots = slots;
+    env->slot_cap = slot_cap;
+    env->slot_used = 0;
+    i = 0;
+    while (i < env->count)
+    {
+        env_place(env, env->vars[i].hash, (int)i);
+        i++;
+    }
+    return (0);
+}
+
+/**
+ * env_reserve - Make room for one more variable
+ * @env: Environment store
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+static int env_reserve(t_env *env)
+{
+    t_env_var   *vars;
+    size_t      cap;
+    size_t      slot_cap;
+    
+    if (env->count == env->cap)
+    {
+        cap = env->cap * 2;
+        if (cap < ENV_MIN_SLOTS / 2)
+            cap = ENV_MIN_SLOTS / 2;
+        vars = malloc(cap * sizeof(t_env_var));
+        if (!vars)
+            return (-1);
+        if (env->count)
+            memcpy(vars, env->vars, env->count * sizeof(t_env_var));
+        free(env->vars);
+        env->vars = vars;
+        env->cap = cap;
+    }
+    /* Keep the load factor (live + deleted) under 3/4 */
+    if ((env->slot_used + 1) * 4 > env->slot_cap * 3)
+    {
+        slot_cap = env->slot_cap;
+        if (slot_cap < ENV_MIN_SLOTS)
+            slot_cap = ENV_MIN_SLOTS;
+        while ((env->count + 1) * 2 > slot_cap)
+            slot_cap *= 2;
+        return (env_rehash(env, slot_cap));
+    }
+    return (0);
+}
+
+/**
+ * env_add - Insert or replace a "KEY=VALUE" string, taking ownership of it
+ * @env: Environment store
+ * @str: Heap-allocated "KEY=VALUE" string
+ * @key_len: Length of KEY
+ *
+ * Return: 0 on success, -1 on allocation failure (str is freed)
+ */
+static int env_add(t_env *env, char *str, size_t key_len)
+{
+    unsigned int    hash;
+    long            slot;
+    t_env_var       *var;
+    
+    hash = hash_string(str, key_len);
+    slot = env_find_slot(env, str, key_len, hash);
+    if (slot >= 0)
+    {
+        var = &env->vars[env->slots[slot]];
+        free(var->str);
+        var->str = str;
+        env->generation++;
+        return (0);
+    }
+    if (env_reserve(env) == -1)
+    {
+        free(str);
+        return (-1);
+    }
+    var = &env->vars[env->count];
+    var->str = str;
+    var->key_len = key_len;
+    var->hash = hash;
+    env_place(env, hash, (int)env->count);
+    env->count++;
+    env->generation++;
+    return (0);
+}
+
+/**
+ * env_init - Build the store from the process environment
+ * @env: Environment store to initialize
+ * @envp: NULL-terminated "KEY=VALUE" array
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+int     env_init(t_env *env, char **envp)
+{
+    char    *str;
+    char    *eq;
+    size_t  i;
+    
+    ft_bzero(env, sizeof(t_env));
+    env->generation = 1;
+    i = 0;
+    while (envp && envp[i])
+    {
+        eq = ft_strchr(envp[i], '=');
+        if (eq)
+        {
+            str = ft_strdup(envp[i]);
+            if (!str || env_add(env, str, eq - envp[i]) == -1)
+                return (-1);
+        }
+        i++;
+    }
+    return (0);
+}
+
+/**
+ * env_destroy - Free everything owned by the store
+ * @env: Environment store
+ */
+void    env_destroy(t_env *env)
+{
+    size_t  i;
+    
+    i = 0;
+    while (i < env->count)
+        free(env->vars[i++].str);
+    free(env->vars);
+    free(env->slots);
+    free(env->envp);
+    ft_bzero(env, sizeof(t_env));
+}
+
+/**
+ * env_get - Look up a variable
+ * @env: Environment store
+ * @key: Variable name (not necessarily NUL-terminated)
+ * @key_len: Length of the name
+ *
+ * Return: Pointer to the value inside the store, or NULL if unset
+ */
+char    *env_get(t_env *env, const char *key, size_t key_len)
+{
+    long    slot;
+    
+    slot = env_find_slot(env, key, key_len, hash_string(key, key_len));
+    if (slot < 0)
+        return (NULL);
+    return (env->vars[env->slots[slot]].str + key_len + 1);
+}
+
+/**
+ * env_set - Set a variable, replacing any previous value
+ * @env: Environment store
+ * @key: Variable name
+ * @value: Value to set
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+int     env_set(t_env *env, const char *key, const char *value)
+{
+    size_t  key_len;
+    size_t  value_len;
+    char    *str;
+    
+    key_len = ft_strlen(key);
+    value_len = ft_strlen(value);
+    str = malloc(key_len + value_len + 2);
+    if (!str)
+        return (-1);
+    memcpy(str, key, key_len);
+    str[key_len] = '=';
+    memcpy(str + key_len + 1, value, value_len + 1);
+    return (env_add(env, str, key_len));
+}
+
+/**
+ * env_unset - Remove a variable
+ * @env: Environment store
+ * @key: Variable name
+ *
+ * Return: 0 if the variable was removed, -1 if it was not set
+ */
+int     env_unset(t_env *env, const char *key)
+{
+    size_t          key_len;
+    unsigned int    hash;
+    long            slot;
+    long            last_slot;
+    int             idx;
+    t_env_var       *last;
+    
+    key_len = ft_strlen(key);
+    hash = hash_string(key, key_len);
+    slot = env_find_slot(env, key, key_len, hash);
+    if (slot < 0)
+        return (-1);
+    idx = env->slots[slot];
+    env->slots[slot] = ENV_SLOT_DELETED;
+    free(env->vars[idx].str);
+    
+    /* Move the last variable into the hole */
+    env->count--;
+    if ((size_t)idx != env->count)
+    {
+        last = &env->vars[env->count];
+        last_slot = env_find_slot(env, last->str, last->key_len, last->hash);
+        env->slots[last_slot] = idx;
+        env->vars[idx] = *last;
+    }
+    env->generation++;
+    return (0);
+}
+
+/**
+ * env_envp - Get a NULL-terminated array suitable for execve
+ * @env: Environment store
+ *
+ * The array is cached and only rebuilt after the store has changed.
+ * It stays valid until the next modification of the store.
+ *
+ * Return: envp array, or NULL on allocation failure
+ */
+char    **env_envp(t_env *env)
+{
+    char    **envp;
+    size_t  i;
+    
+    if (env->envp && env->envp_generation == env->generation)
+        return (env->envp);
+    if (!env->envp || env->envp_cap < env->count + 1)
+    {
+        envp = malloc((env->cap + 1) * sizeof(char *));
+        if (!envp)
+            return (NULL);
+        free(env->envp);
+        env->envp = envp;
+        env->envp_cap = env->cap + 1;
+    }
+    i = 0;
+    while (i < env->count)
+    {
+        env->envp[i] = env->vars[i].str;
+        i++;
+    }
+    env->envp[i] = NULL;
+    env->envp_generation = env->generation;
+    return (env->envp);
+}
@@ -6,154 +6,170 @@
 /**
  * get_env_value - Get value of environment variable
  * @key: Environment variable key
- * @env: Environment variable array
+ * @env: Environment store
  *
  * Return: Value string or NULL if not found
  */
-char    *get_env_value(char *key, char **env)
+char    *get_env_value(char *key, t_env *env)
 {
-    size_t  key_len;
-    size_t  i;
-    
     if (!key || !env)
         return (NULL);
-    
-    key_len = ft_strlen(key);
-    i = 0;
-    while (env[i])
-    {
-        if (ft_strncmp(env[i], key, key_len) == 0 && env[i][key_len] == '=')
-            return (env[i] + key_len + 1);
-        i++;
-    }
-    return (NULL);
+    return (env_get(env, key, ft_strlen(key)));
 }
 
 /**
  * set_env_value - Set environment variable
  * @key: Environment variable key
  * @value: Value to set
- * @env: Environment variable array pointer
+ * @env: Environment store
  */
-void    set_env_value(char *key, char *value, char ***env)
+void    set_env_value(char *key, char *value, t_env *env)
 {
-    size_t  i;
-    size_t  key_len;
-    char    *new_var;
-    
     if (!key || !value || !env)
         return;
     
-    key_len = ft_strlen(key);
+    /* Cached command paths depend on PATH */
+    if (ft_strcmp(key, "PATH") == 0)
+        hash_flush();
     
-    /* Check if variable already exists */
-    i = 0;
-    while ((*env)[i])
-    {
-        if (ft_strncmp((*env)[i], key, key_len) == 0 && (*env)[i][key_len] == '=')
-        {
-            /* Variable exists, replace it */
-            free((*env)[i]);
-            new_var = ft_strjoin(key, "=");
-            new_var = ft_strjoin(new_var, value);
-            (*env)[i] = new_var;
-            return;
-        }
-        i++;
-    }
+    env_set(env, key, value);
     
-    /* Variable doesn't exist, add it */
-    char **new_env = malloc((i + 2) * sizeof(char *));
-    if (!new_env)
+    /* The PATH index of this shell is rebuilt for the new directories */
+    if (ft_strcmp(key, "PATH") == 0 && g_global.pathindex.owner == getpid())
+        pathindex_start(env);
+}
+
+/**
+ * unset_env_value - Remove environment variable
+ * @key: Environment variable key
+ * @env: Environment store
+ */
+void    unset_env_value(char *key, t_env *env)
+{
+    if (!key || !env)
         return;
     
-    /* Copy existing variables */
-    size_t j = 0;
-    while (j < i)
-    {
-        new_env[j] = (*env)[j];
-        j++;
-    }
+    /* Cached command paths depend on PATH */
+    if (ft_strcmp(key, "PATH") == 0)
+        hash_flush();
     
-    /* Add new variable */
-    new_var = ft_strjoin(key, "=");
-    new_var = ft_strjoin(new_var, value);
-    new_env[i] = new_var;
-    new_env[i + 1] = NULL;
+    env_unset(env, key);
     
-    /* Free old environment and replace */
-    free(*env);
-    *env = new_env;
+    /* The PATH index of this shell is rebuilt for the new directories */
+    if (ft_strcmp(key, "PATH") == 0 && g_global.pathindex.owner == getpid())
+        pathindex_start(env);
+}
+
+/**
+ * is_name_char - Check if character may appear in a variable name
+ * @c: Character to check
+ *
+ * Return: 1 if valid, 0 otherwise
+ */
+static int is_name_char(int c)
+{
+    return (ft_isalnum(c) || c == '_');
 }
 
 /**
- * expand_env_vars - Expand environment variables in string
- * @str: String with potential environment variables
- * @env: Environment variable array
+ * expand_variable - Expand one $ reference
+ * @sb: Buffer receiving the expansion
+ * @s: Text starting just after the '$'
+ * @len: Bytes available in s
+ * @env: Environment store
  *
- * Return: New string with expanded variables or NULL on failure
+ * Handles $NAME, ${NAME}, $? and $!. Anything else is copied as a
+ * literal '$'.
+ *
+ * Return: Number of bytes of s consumed, or -1 on allocation failure
  */
-char    *expand_env_vars(char *str, char **env)
+static long expand_variable(t_strbuf *sb, const char *s, size_t len, t_env *env)
 {
     size_t  i;
     size_t  start;
-    char    *result;
-    char    *var_name;
-    char    *var_value;
-    char    *temp;
+    char    *value;
     
-    if (!str)
-        return (NULL);
+    if (len > 0 && s[0] == '?')
+    {
+        if (strbuf_putnbr(sb, g_global.exit_status) == -1)
+            return (-1);
+        return (1);
+    }
+    if (len > 0 && s[0] == '!')
+    {
+        /* Pid of the last background job, empty if there was none */
+        if (g_global.jobs.last_pid > 0
+            && strbuf_putnbr(sb, g_global.jobs.last_pid) == -1)
+            return (-1);
+        return (1);
+    }
     
-    result = ft_strdup("");
-    i = 0;
+    start = 0;
+    if (len > 0 && s[0] == '{')
+        start = 1;
+    i = start;
+    while (i < len && is_name_char(s[i]))
+        i++;
     
-    while (str[i])
+    /* Not a valid reference: "$", "$-", "${", "${}" or "${X" stay literal */
+    if (i == start || (start && (i == len || s[i] != '}')))
     {
-        if (str[i] == '$')
-        {
-            i++;  /* Skip $ */
-            start = i;
-            
-            /* Find variable name */
-            while (str[i] && (ft_isalnum(str[i]) || str[i] == '_'))
-                i++;
-            
-            if (i > start)
-            {
-                /* Extract variable name */
-                var_name = ft_substr(str, start, i - start);
-                
-                /* Get variable value */
-                var_value = get_env_value(var_name, env);
-                if (var_value)
-                {
-                    temp = result;
-                    result = ft_strjoin(result, var_value);
-                    free(temp);
-                }
-                free(var_name);
-            }
-            else
-            {
-                /* Invalid variable name, just add $ */
-                temp = result;
-                result = ft_strjoin(result, "$");
-                free(temp);
-            }
-        }
-        else
+        if (strbuf_putc(sb, '$') == -1)
+            return (-1);
+        return (0);
+    }
+    
+    value = env_get(env, s + start, i - start);
+    if (value && strbuf_append(sb, value, ft_strlen(value)) == -1)
+        return (-1);
+    if (start)
+        i++;  /* Skip '}' */
+    return ((long)i);
+}
+
+/**
+ * expand_append - Append text to a buffer with variables expanded
+ * @sb: Buffer receiving the result
+ * @str: Text to expand (not necessarily NUL-terminated)
+ * @len: Length of text
+ * @env: Environment store
+ *
+ * Single pass: literal runs between '$' signs are copied in bulk.
+ * "$(...)" is replaced by the output of the command inside.
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+int     expand_append(t_strbuf *sb, const char *str, size_t len, t_env *env)
+{
+    const char  *dollar;
+    size_t      i;
+    long        used;
+    
+    i = 0;
+    while (i < len)
+    {
+        dollar = ft_memchr(str + i, '$', len - i);
+        if (!dollar)
+            return (strbuf_append(sb, str + i, len - i));
+        if (strbuf_append(sb, str + i, dollar - (str + i)) == -1)
+            return (-1);
+        i = dollar - str + 1;
+        used = -1;
+        if (i < len && str[i] == '(')
+            used = subst_end(str, i + 1, len);
+        if (used != -1)
         {
-            /* Regular character */
-            char char_str[2] = {str[i], '\0'};
-            temp = result;
-            result = ft_strjoin(result, char_str);
-            free(temp);
-            i++;
+            if (subst_append(sb, str + i + 1, used - i - 1, env) == -1)
+                return (-1);
+            i = used + 1;
+            continue;
         }
+        used = expand_variable(sb, str + i, len - i, env);
+        if (used == -1)
+            return (-1);
+        i += used;
     }
-    
-    return (result);
+    return (0);
 }
 
 /**
@@ -4,7 +4,7 @@
 #include "minishell.h"
 
 /* Global variable - only one allowed per requirements */
-t_global g_global = {0, NULL};
+t_global g_global = {0};
 
 /**
  * init_globals - Initialize global variables
@@ -12,24 +12,51 @@ t_global g_global = {0, NULL};
  */
 void    init_globals(char **envp)
 {
-    int i;
-    int env_count;
+    char    *backend;
+    char    *simd;
+    char    *trace;
+    char    *stats;
     
     g_global.exit_status = 0;
     
-    /* Count environment variables */
-    env_count = 0;
-    while (envp[env_count])
-        env_count++;
+    /* Copy environment variables into the indexed store */
+    if (env_init(&g_global.env, envp) == -1)
+        exit(1);
+    
+    /* Arena for everything built from one command line */
+    if (arena_init(&g_global.arena, 0) == -1)
+        exit(1);
+    strbuf_init(&g_global.scratch);
+    
+    /* No signalfd until setup_signal_handlers */
+    g_global.jobs.sigfd = -1;
     
-    /* Allocate and copy environment variables */
-    g_global.env = malloc((env_count + 1) * sizeof(char *));
-    if (!g_global.env)
+    /* Builtins write to stdout through a buffer, not stdio */
+    if (out_init(&g_global.out, STDOUT_FILENO) == -1)
         exit(1);
     
-    for (i = 0; envp[i]; i++)
-        g_global.env[i] = ft_strdup(envp[i]);
-    g_global.env[env_count] = NULL;
+    /* Process launch backend, overridable with --spawn */
+    g_global.spawn_backend = SPAWN_POSIX;
+    g_global.helper.fd = -1;
+    g_global.pathindex.fd = -1;
+    backend = get_env_value("MINISHELL_SPAWN", &g_global.env);
+    if (backend && spawn_backend_from_name(backend) != -1)
+        g_global.spawn_backend = spawn_backend_from_name(backend);
+    
+    /* libft kernels default to the best the CPU supports */
+    simd = get_env_value("MINISHELL_SIMD", &g_global.env);
+    if (simd && simd_select(simd_level_from_name(simd)) == -1)
+        fprintf(stderr, "minishell: MINISHELL_SIMD: %s: not supported\n", simd);
+    
+    /* Opt-in phase tracing, also enabled with --trace */
+    trace = get_env_value("MINISHELL_TRACE", &g_global.env);
+    if (trace && *trace)
+        trace_init(trace);
+    
+    /* Counters as JSON at exit, also enabled with --stats-json */
+    stats = get_env_value("MINISHELL_STATS_JSON", &g_global.env);
+    if (stats && *stats)
+        stats_init(stats);
 }
 
 /**
@@ -37,13 +64,14 @@ void    init_globals(char **envp)
  */
 void    cleanup_globals(void)
 {
-    int i;
-    
-    if (g_global.env)
-    {
-        for (i = 0; g_global.env[i]; i++)
-            free(g_global.env[i]);
-        free(g_global.env);
-        g_global.env = NULL;
-    }
-}
\ No newline at end of file
+    hash_flush();
+    env_destroy(&g_global.env);
+    arena_destroy(&g_global.arena);
+    strbuf_free(&g_global.scratch);
+    out_destroy(&g_global.out);
+    jobs_destroy();
+    helper_stop();
+    pathindex_stop();
+    free(g_global.server.path);
+    g_global.server.path = NULL;
+}
@@ -0,0 +1,336 @@
+/* hash.c - Command hash table for Minishell */
+/* Author: your_login */
+
+#include "minishell.h"
+
+/**
+ * hash_string - Hash a string of known length (FNV-1a)
+ * @s: String to hash (not necessarily NUL-terminated)
+ * @len: Number of bytes to hash
+ *
+ * Return: 32-bit hash value
+ */
+unsigned int    hash_string(const char *s, size_t len)
+{
+    unsigned int    h;
+    size_t          i;
+    
+    h = 2166136261u;
+    i = 0;
+    while (i < len)
+    {
+        h ^= (unsigned char)s[i];
+        h *= 16777619u;
+        i++;
+    }
+    return (h);
+}
+
+/**
+ * hash_name - Compute bucket index for a command name
+ * @name: Command name
+ *
+ * Return: Bucket index in g_global.cmd_hash
+ */
+static unsigned int hash_name(const char *name)
+{
+    return (hash_string(name, ft_strlen(name)) & (CMD_HASH_SIZE - 1));
+}
+
+/**
+ * hash_find - Find entry for a command name
+ * @name: Command name
+ *
+ * Return: Entry or NULL if the name is not hashed
+ */
+static t_cmd_hash *hash_find(const char *name)
+{
+    t_cmd_hash  *entry;
+    
+    entry = g_global.cmd_hash[hash_name(name)];
+    while (entry)
+    {
+        if (ft_strcmp(entry->name, name) == 0)
+            return (entry);
+        entry = entry->next;
+    }
+    return (NULL);
+}
+
+/**
+ * hash_lookup - Look up a command in the hash table
+ * @name: Command name
+ * @found: Set to 1 if the name is hashed (even as "not found"), 0 otherwise
+ *
+ * Return: Cached path, or NULL for a miss or a negative entry
+ */
+char    *hash_lookup(const char *name, int *found)
+{
+    t_cmd_hash  *entry;
+    
+    entry = hash_find(name);
+    if (!entry)
+    {
+        *found = 0;
+        return (NULL);
+    }
+    *found = 1;
+    entry->hits++;
+    return (entry->path);
+}
+
+/**
+ * hash_insert - Remember the resolved path of a command
+ * @name: Command name
+ * @path: Full path, or NULL to record that the command was not found
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+int     hash_insert(const char *name, const char *path)
+{
+    t_cmd_hash      *entry;
+    char            *new_path;
+    unsigned int    idx;
+    
+    new_path = NULL;
+    if (path)
+    {
+        new_path = ft_strdup(path);
+        if (!new_path)
+            return (-1);
+    }
+    
+    entry = hash_find(name);
+    if (entry)
+    {
+        /* Replace the existing mapping */
+        free(entry->path);
+        entry->path = new_path;
+        entry->pinned = 0;
+        return (0);
+    }
+    
+    entry = malloc(sizeof(t_cmd_hash));
+    if (!entry)
+    {
+        free(new_path);
+        return (-1);
+    }
+    entry->name = ft_strdup(name);
+    if (!entry->name)
+    {
+        free(new_path);
+        free(entry);
+        return (-1);
+    }
+    entry->path = new_path;
+    entry->hits = 0;
+    entry->pinned = 0;
+    
+    idx = hash_name(name);
+    entry->next = g_global.cmd_hash[idx];
+    g_global.cmd_hash[idx] = entry;
+    return (0);
+}
+
+/**
+ * hash_pin - Remember a path given by the user
+ * @name: Command name
+ * @path: Full path
+ *
+ * Pinned entries survive PATH index updates; only hash -r, hash -d and a
+ * change of PATH drop them.
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+int     hash_pin(const char *name, const char *path)
+{
+    if (hash_insert(name, path) == -1)
+        return (-1);
+    hash_find(name)->pinned = 1;
+    return (0);
+}
+
+/**
+ * hash_forget - Forget a command after its PATH directories changed
+ * @name: Command name
+ */
+void    hash_forget(const char *name)
+{
+    t_cmd_hash  *entry;
+
+    entry = hash_find(name);
+    if (entry && !entry->pinned)
+        hash_remove(name);
+}
+
+/**
+ * hash_remove - Forget a single command
+ * @name: Command name
+ *
+ * Return: 0 if the name was hashed, -1 otherwise
+ */
+int     hash_remove(const char *name)
+{
+    t_cmd_hash  **link;
+    t_cmd_hash  *entry;
+    
+    link = &g_global.cmd_hash[hash_name(name)];
+    while (*link)
+    {
+        entry = *link;
+        if (ft_strcmp(entry->name, name) == 0)
+        {
+            *link = entry->next;
+            free(entry->name);
+            free(entry->path);
+            free(entry);
+            return (0);
+        }
+        link = &entry->next;
+    }
+    return (-1);
+}
+
+/**
+ * hash_flush - Forget every hashed command
+ *
+ * Called whenever PATH changes, since every mapping may now be stale.
+ */
+void    hash_flush(void)
+{
+    t_cmd_hash  *entry;
+    t_cmd_hash  *next;
+    int         i;
+    
+    i = 0;
+    while (i < CMD_HASH_SIZE)
+    {
+        entry = g_global.cmd_hash[i];
+        while (entry)
+        {
+            next = entry->next;
+            free(entry->name);
+            free(entry->path);
+            free(entry);
+            entry = next;
+        }
+        g_global.cmd_hash[i] = NULL;
+        i++;
+    }
+}
+
+/**
+ * hash_print - Print the hash table in the format used by bash
+ *
+ * Return: 0 on success, 1 on write error
+ */
+static int hash_print(void)
+{
+    t_cmd_hash  *entry;
+    char        hits[16];
+    int         i;
+    int         empty;
+    
+    empty = 1;
+    i = 0;
+    while (i < CMD_HASH_SIZE)
+    {
+        entry = g_global.cmd_hash[i];
+        while (entry)
+        {
+            if (entry->path)
+            {
+                if (empty)
+                    out_str(&g_global.out, "hits\tcommand\n");
+                empty = 0;
+                snprintf(hits, sizeof(hits), "%4d\t", entry->hits);
+                out_str(&g_global.out, hits);
+                out_str(&g_global.out, entry->path);
+                out_putc(&g_global.out, '\n');
+            }
+            entry = entry->next;
+        }
+        i++;
+    }
+    if (empty)
+        out_str(&g_global.out, "hash: hash table empty\n");
+    g_global.exit_status = builtin_flush("hash");
+    return (g_global.exit_status);
+}
+
+/**
+ * ft_hash - Implement hash builtin
+ * @argv: Command arguments
+ * @argc: Argument count
+ * @env: Environment store
+ *
+ * Usage: hash            list remembered commands
+ *        hash -r         forget every remembered command
+ *        hash -d name    forget one command
+ *        hash -p path name  remember name as path without searching
+ *        hash name...    search PATH and remember each name
+ *
+ * Return: 0 on success, 1 on error
+ */
+int     ft_hash(char **argv, int argc, t_env *env)
+{
+    char    *path;
+    int     status;
+    int     i;
+    
+    g_global.exit_status = 0;
+    if (argc == 1)
+        return (hash_print());
+    
+    if (ft_strcmp(argv[1], "-r") == 0)
+    {
+        hash_flush();
+        return (0);
+    }
+    if (ft_strcmp(argv[1], "-p") == 0)
+    {
+        if (argc != 4)
+        {
+            fprintf(stderr, "hash: usage: hash -p path name\n");
+            g_global.exit_status = 1;
+            return (1);
+        }
+        hash_pin(argv[3], argv[2]);
+        return (0);
+    }
+    
+    status = 0;
+    if (ft_strcmp(argv[1], "-d") == 0)
+    {
+        i = 2;
+        while (i < argc)
+        {
+            if (hash_remove(argv[i]) == -1)
+            {
+                fprintf(stderr, "hash: %s: not found\n", argv[i]);
+                status = 1;
+            }
+            i++;
+        }
+        g_global.exit_status = status;
+        return (status);
+    }
+    
+    i = 1;
+    while (i < argc)
+    {
+        /* Drop any stale mapping so find_executable searches PATH again */
+        hash_remove(argv[i]);
+        path = find_executable(argv[i], env);
+        if (!path)
+        {
+            fprintf(stderr, "hash: %s: not found\n", argv[i]);
+            status = 1;
+        }
+        free(path);
+        i++;
+    }
+    g_global.exit_status = status;
+    return (status);
+}
@@ -0,0 +1,351 @@
+/* heredoc.c - Here-documents for Minishell */
+/* Author: your_login */
+
+#define _GNU_SOURCE
+#include "minishell.h"
+#include <pthread.h>
+#include <sys/mman.h>
+
+#define HEREDOC_PIPE_MIN    65536   /* pipe capacity assumed if unknown */
+
+/*
+ * The body of '<< DELIM' is read from the shell's own input while the
+ * command is parsed, expanded in one pass per line (unless the delimiter
+ * was quoted), and collected in memory. Nothing is written to disk:
+ *
+ *   memfd_create  the body is written to an anonymous in-memory file,
+ *                 rewound, and the descriptor becomes the child's stdin
+ *   pipe          fallback for kernels without memfd; bodies that fit in
+ *                 the pipe are written at once, bigger ones by a detached
+ *                 writer thread so the shell never blocks on its reader
+ *
+ * Either way cmd->heredoc_fd is a close-on-exec read descriptor, closed
+ * by close_heredocs() once the line has run.
+ *
+ * A writer thread's write end is close-on-exec, but a forked child that
+ * does not exec (a builtin stage, a substitution) would still hold it, and
+ * the reader would not see EOF until that child exits. The write ends are
+ * kept in g_global.heredoc_writers, and a pthread_atfork handler closes
+ * them in every forked child.
+ */
+
+typedef struct s_heredoc_job {
+    int     fd;
+    char    *data;
+    size_t  len;
+}   t_heredoc_job;
+
+/**
+ * write_all - Write a whole buffer, retrying short writes
+ * @fd: Descriptor
+ * @data: Bytes to write
+ * @len: Number of bytes
+ *
+ * Return: 0 on success, -1 on error
+ */
+static int  write_all(int fd, const char *data, size_t len)
+{
+    ssize_t n;
+
+    while (len > 0)
+    {
+        n = write(fd, data, len);
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n == -1)
+            return (-1);
+        data += n;
+        len -= n;
+    }
+    return (0);
+}
+
+/**
+ * heredoc_read_body - Collect a here-document body from the shell input
+ * @body: Buffer receiving the body, one '\n' after every line
+ * @delim: Line that ends the body
+ * @expand: Expand variables in the body
+ * @env: Environment store
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+static int  heredoc_read_body(t_strbuf *body, const char *delim, int expand,
+                              t_env *env)
+{
+    char    *line;
+
+    while (1)
+    {
+        if (g_global.interactive)
+        {
+            printf("> ");
+            fflush(stdout);
+        }
+        line = input_read_line(&g_global.input);
+        if (!line)
+        {
+            fprintf(stderr, "minishell: warning: here-document delimited by "
+                "end-of-file (wanted `%s')\n", delim);
+            return (0);
+        }
+        if (ft_strcmp(line, delim) == 0)
+            return (0);
+        if (expand && expand_append(body, line, ft_strlen(line), env) == -1)
+            return (-1);
+        if (!expand && strbuf_append(body, line, ft_strlen(line)) == -1)
+            return (-1);
+        if (strbuf_putc(body, '\n') == -1)
+            return (-1);
+    }
+}
+
+/**
+ * heredoc_memfd - Hand a body over through an in-memory file
+ * @body: Collected body
+ *
+ * Return: Read descriptor positioned at the start, or -1 on error
+ */
+static int  heredoc_memfd(t_strbuf *body)
+{
+    int fd;
+
+    fd = memfd_create("heredoc", MFD_CLOEXEC);
+    if (fd == -1)
+        return (-1);
+    if (write_all(fd, body->data, body->len) == -1
+        || lseek(fd, 0, SEEK_SET) == -1)
+    {
+        close(fd);
+        return (-1);
+    }
+    return (fd);
+}
+
+/**
+ * writers_lock - Keep the writer list still across fork()
+ */
+static void writers_lock(void)
+{
+    pthread_mutex_lock(&g_global.heredoc_writers.lock);
+}
+
+/**
+ * writers_unlock - Release the writer list in the parent after fork()
+ */
+static void writers_unlock(void)
+{
+    pthread_mutex_unlock(&g_global.heredoc_writers.lock);
+}
+
+/**
+ * writers_close - Drop the writer threads' write ends in a forked child
+ *
+ * The threads did not survive the fork, so their descriptors are closed
+ * here and the list is emptied.
+ */
+static void writers_close(void)
+{
+    t_heredoc_writers   *w;
+
+    w = &g_global.heredoc_writers;
+    while (w->count > 0)
+        close(w->fds[--w->count]);
+    pthread_mutex_unlock(&w->lock);
+}
+
+/**
+ * writers_add - Register the write end of a new writer thread
+ * @fd: Write end
+ *
+ * Return: 0 on success, -1 on error
+ */
+static int  writers_add(int fd)
+{
+    t_heredoc_writers   *w;
+    int                 *fds;
+    int                 ret;
+
+    w = &g_global.heredoc_writers;
+    if (!w->ready)
+    {
+        if (pthread_mutex_init(&w->lock, NULL) != 0)
+            return (-1);
+        if (pthread_atfork(writers_lock, writers_unlock, writers_close) != 0)
+        {
+            pthread_mutex_destroy(&w->lock);
+            return (-1);
+        }
+        w->ready = 1;
+    }
+    ret = 0;
+    pthread_mutex_lock(&w->lock);
+    if (w->count == w->cap)
+    {
+        fds = realloc(w->fds, (w->cap ? w->cap * 2 : 4) * sizeof(int));
+        if (fds)
+        {
+            w->fds = fds;
+            w->cap = w->cap ? w->cap * 2 : 4;
+        }
+    }
+    if (w->count < w->cap)
+        w->fds[w->count++] = fd;
+    else
+        ret = -1;
+    pthread_mutex_unlock(&w->lock);
+    return (ret);
+}
+
+/**
+ * writers_remove - Unregister and close the write end of a writer
+ * @fd: Write end
+ *
+ * Both happen under the lock, so a fork never sees the number after it
+ * was closed and maybe reused.
+ */
+static void writers_remove(int fd)
+{
+    t_heredoc_writers   *w;
+    size_t              i;
+
+    w = &g_global.heredoc_writers;
+    pthread_mutex_lock(&w->lock);
+    i = 0;
+    while (i < w->count && w->fds[i] != fd)
+        i++;
+    if (i < w->count)
+        w->fds[i] = w->fds[--w->count];
+    close(fd);
+    pthread_mutex_unlock(&w->lock);
+}
+
+/**
+ * heredoc_writer - Thread feeding a large body into a pipe
+ * @arg: t_heredoc_job, owned by the thread
+ *
+ * SIGPIPE is blocked here, so a reader that exits early gives EPIPE
+ * instead of killing the shell.
+ *
+ * Return: NULL
+ */
+static void *heredoc_writer(void *arg)
+{
+    t_heredoc_job   *job;
+    sigset_t        set;
+
+    job = arg;
+    sigemptyset(&set);
+    sigaddset(&set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &set, NULL);
+    write_all(job->fd, job->data, job->len);
+    writers_remove(job->fd);
+    free(job->data);
+    free(job);
+    return (NULL);
+}
+
+/**
+ * heredoc_pipe - Hand a body over through a pipe
+ * @body: Collected body; emptied if a writer thread takes it over
+ *
+ * Return: Read end of the pipe, or -1 on error
+ */
+static int  heredoc_pipe(t_strbuf *body)
+{
+    t_heredoc_job   *job;
+    pthread_t       thread;
+    int             fds[2];
+    long            cap;
+
+    if (pipe2(fds, O_CLOEXEC) == -1)
+        return (-1);
+    cap = HEREDOC_PIPE_MIN;
+#ifdef F_GETPIPE_SZ
+    cap = fcntl(fds[1], F_GETPIPE_SZ);
+    if (cap < HEREDOC_PIPE_MIN)
+        cap = HEREDOC_PIPE_MIN;
+#endif
+    if (body->len <= (size_t)cap)
+    {
+        /* Fits: the write cannot block */
+        write_all(fds[1], body->data, body->len);
+        close(fds[1]);
+        return (fds[0]);
+    }
+    job = malloc(sizeof(t_heredoc_job));
+    if (!job)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        return (-1);
+    }
+    job->fd = fds[1];
+    job->len = body->len;
+    if (writers_add(fds[1]) == -1)
+    {
+        free(job);
+        close(fds[0]);
+        close(fds[1]);
+        return (-1);
+    }
+    job->data = strbuf_detach(body);
+    if (pthread_create(&thread, NULL, heredoc_writer, job) != 0)
+    {
+        free(job->data);
+        free(job);
+        close(fds[0]);
+        writers_remove(fds[1]);
+        return (-1);
+    }
+    pthread_detach(thread);
+    return (fds[0]);
+}
+
+/**
+ * heredoc_open - Read a here-document and get a descriptor for its body
+ * @delim: Delimiter, with quotes already removed
+ * @quoted: Delimiter had quotes, so the body is taken literally
+ * @env: Environment store
+ *
+ * Return: Close-on-exec read descriptor, or -1 on error (reported)
+ */
+int     heredoc_open(const char *delim, int quoted, t_env *env)
+{
+    t_strbuf    body;
+    int         fd;
+
+    strbuf_init(&body);
+    fd = -1;
+    if (heredoc_read_body(&body, delim, !quoted, env) == 0)
+    {
+        fd = heredoc_memfd(&body);
+        if (fd == -1 && (errno == ENOSYS || errno == EINVAL))
+            fd = heredoc_pipe(&body);
+    }
+    if (fd == -1)
+    {
+        fprintf(stderr, "minishell: here-document: %s\n", strerror(errno));
+        g_global.exit_status = 1;
+    }
+    strbuf_free(&body);
+    return (fd);
+}
+
+/**
+ * close_heredocs - Close the here-document descriptors of a line
+ * @cmds: Commands of the line
+ * @count: Number of commands
+ */
+void    close_heredocs(t_cmd *cmds, int count)
+{
+    int i;
+
+    i = 0;
+    while (i < count)
+    {
+        if (cmds[i].heredoc_fd >= 0)
+            close(cmds[i].heredoc_fd);
+        cmds[i].heredoc_fd = -1;
+        i++;
+    }
+}
@@ -0,0 +1,271 @@
+/* input.c - Line reader for interactive and batch input */
+/* Author: your_login */
+
+#include "minishell.h"
+#include <poll.h>
+#include <sys/mman.h>
+
+#define INPUT_BUF_SIZE  65536
+
+/*
+ * Lines are returned as NUL-terminated, writable strings inside the
+ * reader's own buffer (the lexer terminates words in place). A line stays
+ * valid until the next call to input_read_line.
+ *
+ * Three sources are supported:
+ *   - a file descriptor, read with read(2) into one reusable buffer
+ *   - a script file, mapped privately with mmap (copy-on-write)
+ *   - a string, for -c
+ */
+
+/**
+ * input_open_fd - Read lines from a file descriptor
+ * @in: Reader to initialize
+ * @fd: Descriptor to read from
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+int     input_open_fd(t_input *in, int fd)
+{
+    ft_bzero(in, sizeof(t_input));
+    in->fd = fd;
+    in->cap = INPUT_BUF_SIZE;
+    in->buf = malloc(in->cap);
+    if (!in->buf)
+        return (-1);
+    return (0);
+}
+
+/**
+ * input_open_string - Read lines from a string
+ * @in: Reader to initialize
+ * @s: Source text (copied)
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+int     input_open_string(t_input *in, const char *s)
+{
+    ft_bzero(in, sizeof(t_input));
+    in->fd = -1;
+    in->len = ft_strlen(s);
+    in->cap = in->len + 1;
+    in->buf = ft_strdup(s);
+    in->eof = 1;
+    if (!in->buf)
+        return (-1);
+    return (0);
+}
+
+/**
+ * input_open_file - Read lines from a script file through mmap
+ * @in: Reader to initialize
+ * @path: Script path
+ *
+ * Return: 0 on success, -1 on error (already reported)
+ */
+int     input_open_file(t_input *in, const char *path)
+{
+    struct stat st;
+    int         fd;
+    
+    ft_bzero(in, sizeof(t_input));
+    in->fd = -1;
+    in->eof = 1;
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1 || fstat(fd, &st) == -1)
+    {
+        fprintf(stderr, "minishell: %s: %s\n", path, strerror(errno));
+        if (fd != -1)
+            close(fd);
+        return (-1);
+    }
+    if (st.st_size > 0)
+    {
+        /* Private and writable: in-place edits never reach the file */
+        in->buf = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE, fd, 0);
+        if (in->buf == MAP_FAILED)
+        {
+            fprintf(stderr, "minishell: %s: %s\n", path, strerror(errno));
+            close(fd);
+            in->buf = NULL;
+            return (-1);
+        }
+        madvise(in->buf, st.st_size, MADV_SEQUENTIAL);
+        in->mapped = 1;
+        in->len = st.st_size;
+        in->cap = st.st_size;
+    }
+    close(fd);
+    return (0);
+}
+
+/**
+ * input_wait - Block until the input is readable, servicing wake_fd
+ * @in: Reader using a file descriptor
+ *
+ * Lets the shell react to events (finished background jobs) while it
+ * sits at the prompt.
+ */
+static void input_wait(t_input *in)
+{
+    struct pollfd   fds[2];
+    
+    if (!in->on_wake)
+        return;
+    fds[0].fd = in->fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = in->wake_fd;
+    fds[1].events = POLLIN;
+    while (1)
+    {
+        fds[0].revents = 0;
+        fds[1].revents = 0;
+        if (poll(fds, 2, -1) == -1 && errno != EINTR)
+            return;
+        if (fds[1].revents & POLLIN)
+            in->on_wake();
+        if (fds[0].revents)
+            return;
+    }
+}
+
+/**
+ * input_fill - Read more data into the buffer
+ * @in: Reader using a file descriptor
+ *
+ * Return: Number of bytes read, 0 at end of input, -1 on error
+ */
+static ssize_t input_fill(t_input *in)
+{
+    char    *buf;
+    ssize_t n;
+    
+    /* Move the partial line to the front, or grow for a very long line */
+    if (in->pos > 0)
+    {
+        memmove(in->buf, in->buf + in->pos, in->len - in->pos);
+        in->len -= in->pos;
+        in->pos = 0;
+    }
+    if (in->len + 1 >= in->cap)
+    {
+        buf = malloc(in->cap * 2);
+        if (!buf)
+            return (-1);
+        memcpy(buf, in->buf, in->len);
+        free(in->buf);
+        in->buf = buf;
+        in->cap *= 2;
+    }
+    input_wait(in);
+    n = read(in->fd, in->buf + in->len, in->cap - in->len - 1);
+    while (n == -1 && errno == EINTR)
+        n = read(in->fd, in->buf + in->len, in->cap - in->len - 1);
+    if (n > 0)
+        in->len += n;
+    return (n);
+}
+
+/**
+ * input_last_line - Return a final line that has no trailing newline
+ * @in: Reader
+ *
+ * A mapped file may end exactly on a page boundary, leaving no room for
+ * the terminator, so the line is copied aside.
+ *
+ * Return: Line, or NULL on allocation failure
+ */
+static char *input_last_line(t_input *in)
+{
+    char    *line;
+    size_t  n;
+    
+    n = in->len - in->pos;
+    line = in->buf + in->pos;
+    in->pos = in->len;
+    if (!in->mapped)
+    {
+        line[n] = '\0';
+        return (line);
+    }
+    in->tail.len = 0;
+    if (strbuf_append(&in->tail, line, n) == -1)
+        return (NULL);
+    return (in->tail.data);
+}
+
+/**
+ * input_read_line - Get the next line without its newline
+ * @in: Reader
+ *
+ * Return: Line inside the reader's buffer, or NULL at end of input
+ */
+char    *input_read_line(t_input *in)
+{
+    char    *line;
+    char    *nl;
+    size_t  scanned;
+    
+    /* Bytes after in->pos already known to hold no newline */
+    scanned = 0;
+    while (1)
+    {
+        nl = ft_memchr(in->buf + in->pos + scanned, '\n',
+                       in->len - in->pos - scanned);
+        if (nl)
+        {
+            *nl = '\0';
+            line = in->buf + in->pos;
+            in->pos = nl - in->buf + 1;
+            return (line);
+        }
+        if (in->eof || in->fd < 0)
+            break;
+        scanned = in->len - in->pos;
+        if (input_fill(in) <= 0)
+            in->eof = 1;
+    }
+    if (in->pos >= in->len)
+        return (NULL);
+    return (input_last_line(in));
+}
+
+/**
+ * input_close - Release the reader's buffers
+ * @in: Reader
+ */
+void    input_close(t_input *in)
+{
+    if (in->mapped)
+        munmap(in->buf, in->cap);
+    else
+        free(in->buf);
+    strbuf_free(&in->tail);
+    ft_bzero(in, sizeof(t_input));
+}
+
+/**
+ * read_full - Read exactly len bytes
+ * @fd: Descriptor
+ * @buf: Destination
+ * @len: Bytes wanted
+ *
+ * Return: 0 on success, -1 on error or early end of stream
+ */
+int     read_full(int fd, void *buf, size_t len)
+{
+    ssize_t n;
+
+    while (len > 0)
+    {
+        n = read(fd, buf, len);
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return (-1);
+        buf = (char *)buf + n;
+        len -= n;
+    }
+    return (0);
+}
@@ -0,0 +1,401 @@
+/* jobs.c - Background jobs for Minishell */
+/* Author: your_login */
+
+#include "minishell.h"
+#include <sys/signalfd.h>
+
+/*
+ * 'cmd &' starts a pipeline without waiting and records its pids in
+ * g_global.jobs. SIGCHLD is blocked for the whole shell and delivered
+ * through a signalfd instead of a handler:
+ *
+ *   - the line reader polls the signalfd together with its input, so
+ *     children are reaped while the shell waits at the prompt
+ *   - jobs_reap() also runs before every prompt/line, which covers input
+ *     that never blocks (-c, scripts)
+ *
+ * Reaping only ever calls wait_child(pid, WNOHANG) on job pids, so the
+ * blocking waits for foreground commands are unaffected. Children get an
+ * empty signal mask back when they are spawned (spawn.c).
+ */
+
+/**
+ * jobs_init - Route SIGCHLD through a signalfd
+ *
+ * Return: 0 on success, -1 if no signalfd could be created (jobs are
+ *         then reaped only before each line)
+ */
+int     jobs_init(void)
+{
+    sigset_t    set;
+
+    sigemptyset(&set);
+    sigaddset(&set, SIGCHLD);
+    if (sigprocmask(SIG_BLOCK, &set, NULL) == -1)
+        return (-1);
+    g_global.jobs.sigfd = signalfd(-1, &set, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (g_global.jobs.sigfd == -1)
+        return (-1);
+    return (0);
+}
+
+/**
+ * jobs_destroy - Release the job table (running jobs are left alone)
+ */
+void    jobs_destroy(void)
+{
+    int i;
+
+    i = 0;
+    while (i < g_global.jobs.count)
+    {
+        free(g_global.jobs.list[i].pids);
+        free(g_global.jobs.list[i].cmdline);
+        i++;
+    }
+    free(g_global.jobs.list);
+    if (g_global.jobs.sigfd >= 0)
+        close(g_global.jobs.sigfd);
+    g_global.jobs.list = NULL;
+    g_global.jobs.count = 0;
+    g_global.jobs.cap = 0;
+    g_global.jobs.sigfd = -1;
+}
+
+/**
+ * job_cmdline - Rebuild the text of a pipeline for job listings
+ * @cmds: Commands of the pipeline
+ * @count: Number of commands
+ *
+ * Return: Heap string, or NULL on allocation failure
+ */
+static char *job_cmdline(t_cmd *cmds, int count)
+{
+    t_strbuf    sb;
+    int         c;
+    int         i;
+
+    strbuf_init(&sb);
+    c = 0;
+    while (c < count)
+    {
+        if (c > 0)
+            strbuf_append(&sb, " | ", 3);
+        i = 0;
+        while (i < cmds[c].argc)
+        {
+            if (i > 0)
+                strbuf_putc(&sb, ' ');
+            strbuf_append(&sb, cmds[c].argv[i], ft_strlen(cmds[c].argv[i]));
+            i++;
+        }
+        c++;
+    }
+    return (strbuf_detach(&sb));
+}
+
+/**
+ * job_add - Record a pipeline started in the background
+ * @pids: Pids of the started stages (-1 entries are skipped)
+ * @npids: Number of entries in pids
+ * @cmds: Commands of the pipeline
+ * @count: Number of commands
+ *
+ * Return: Job id, or -1 on allocation failure
+ */
+int     job_add(pid_t *pids, int npids, t_cmd *cmds, int count)
+{
+    t_jobs  *jobs;
+    t_job   *job;
+    t_job   *list;
+    int     i;
+
+    jobs = &g_global.jobs;
+    if (jobs->count == jobs->cap)
+    {
+        list = malloc((jobs->cap * 2 + 4) * sizeof(t_job));
+        if (!list)
+            return (-1);
+        if (jobs->count)
+            memcpy(list, jobs->list, jobs->count * sizeof(t_job));
+        free(jobs->list);
+        jobs->list = list;
+        jobs->cap = jobs->cap * 2 + 4;
+    }
+    job = &jobs->list[jobs->count];
+    job->pids = malloc(npids * sizeof(pid_t));
+    job->cmdline = job_cmdline(cmds, count);
+    if (!job->pids || !job->cmdline)
+    {
+        free(job->pids);
+        free(job->cmdline);
+        return (-1);
+    }
+    job->npids = 0;
+    i = 0;
+    while (i < npids)
+    {
+        if (pids[i] > 0)
+            job->pids[job->npids++] = pids[i];
+        i++;
+    }
+    job->live = job->npids;
+    job->status = 0;
+    job->id = 1;
+    if (jobs->count > 0)
+        job->id = jobs->list[jobs->count - 1].id + 1;
+    jobs->count++;
+    if (job->npids > 0)
+        jobs->last_pid = job->pids[job->npids - 1];
+    return (job->id);
+}
+
+/**
+ * job_reaped - Record the exit of one process of a job
+ * @job: Job owning the pid
+ * @index: Index of the pid in job->pids
+ * @status: Status from waitpid
+ *
+ * Reaped pids are kept negated, so 'wait PID' still finds the job.
+ */
+static void job_reaped(t_job *job, int index, int status)
+{
+    if (index == job->npids - 1)
+        job->status = exit_status_from_wait(status);
+    job->pids[index] = -job->pids[index];
+    job->live--;
+}
+
+/**
+ * job_remove - Drop a job from the table
+ * @index: Index in g_global.jobs.list
+ */
+static void job_remove(int index)
+{
+    t_jobs  *jobs;
+
+    jobs = &g_global.jobs;
+    free(jobs->list[index].pids);
+    free(jobs->list[index].cmdline);
+    memmove(&jobs->list[index], &jobs->list[index + 1],
+            (jobs->count - index - 1) * sizeof(t_job));
+    jobs->count--;
+}
+
+/**
+ * jobs_reap - Reap finished background processes without blocking
+ *
+ * Drains the signalfd first; when it is available and empty, no child
+ * has changed state and the table is not scanned.
+ */
+void    jobs_reap(void)
+{
+    struct signalfd_siginfo info[8];
+    t_job                   *job;
+    ssize_t                 n;
+    int                     status;
+    int                     i;
+    int                     j;
+
+    if (g_global.jobs.sigfd >= 0)
+    {
+        n = read(g_global.jobs.sigfd, info, sizeof(info));
+        if (n <= 0)
+            return;
+        while (read(g_global.jobs.sigfd, info, sizeof(info)) > 0)
+            ;
+    }
+    i = 0;
+    while (i < g_global.jobs.count)
+    {
+        job = &g_global.jobs.list[i];
+        j = 0;
+        while (j < job->npids)
+        {
+            if (job->pids[j] > 0
+                && wait_child(job->pids[j], &status, WNOHANG) == job->pids[j])
+                job_reaped(job, j, status);
+            j++;
+        }
+        i++;
+    }
+}
+
+/**
+ * jobs_notify - Report and forget finished jobs before a prompt
+ *
+ * Only interactive shells print "[N]  Done  cmd"; scripts keep finished
+ * jobs until 'jobs' or 'wait' collects them.
+ */
+void    jobs_notify(void)
+{
+    t_job   *job;
+    int     i;
+
+    jobs_reap();
+    if (!g_global.interactive)
+        return;
+    i = 0;
+    while (i < g_global.jobs.count)
+    {
+        job = &g_global.jobs.list[i];
+        if (job->live > 0)
+        {
+            i++;
+            continue;
+        }
+        if (job->status == 0)
+            fprintf(stderr, "[%d]  Done                    %s\n", job->id,
+                job->cmdline);
+        else
+            fprintf(stderr, "[%d]  Exit %-18d%s\n", job->id, job->status,
+                job->cmdline);
+        job_remove(i);
+    }
+}
+
+/**
+ * ft_jobs - Implement jobs builtin
+ *
+ * Lists every job; finished ones are shown once and then forgotten.
+ *
+ * Return: 0 on success, 1 on write error
+ */
+int     ft_jobs(void)
+{
+    t_job   *job;
+    char    line[64];
+    int     i;
+
+    jobs_reap();
+    i = 0;
+    while (i < g_global.jobs.count)
+    {
+        job = &g_global.jobs.list[i];
+        if (job->live > 0)
+            snprintf(line, sizeof(line), "[%d]  %-24s", job->id, "Running");
+        else if (job->status == 0)
+            snprintf(line, sizeof(line), "[%d]  %-24s", job->id, "Done");
+        else
+            snprintf(line, sizeof(line), "[%d]  Exit %-19d", job->id,
+                job->status);
+        out_str(&g_global.out, line);
+        out_str(&g_global.out, job->cmdline);
+        out_putc(&g_global.out, '\n');
+
+        /* Referenced by the queued output: flush before freeing */
+        if (job->live == 0)
+        {
+            out_flush(&g_global.out);
+            job_remove(i);
+            continue;
+        }
+        i++;
+    }
+    g_global.exit_status = builtin_flush("jobs");
+    return (g_global.exit_status);
+}
+
+/**
+ * job_wait - Block until every process of a job has exited
+ * @index: Index in g_global.jobs.list; the job is removed afterwards
+ *
+ * Return: Exit status of the job's last process
+ */
+static int  job_wait(int index)
+{
+    t_job   *job;
+    pid_t   pid;
+    int     status;
+    int     j;
+
+    job = &g_global.jobs.list[index];
+    j = 0;
+    while (j < job->npids)
+    {
+        if (job->pids[j] > 0)
+        {
+            pid = wait_child(job->pids[j], &status, 0);
+            while (pid == -1 && errno == EINTR)
+                pid = wait_child(job->pids[j], &status, 0);
+
+            /* Already reaped elsewhere (ECHILD): gone, status unknown */
+            if (pid != job->pids[j])
+                status = W_EXITCODE(127, 0);
+            job_reaped(job, j, status);
+        }
+        j++;
+    }
+    status = job->status;
+    job_remove(index);
+    return (status);
+}
+
+/**
+ * find_job - Look up a job by "%N" or by the pid of one of its processes
+ * @arg: Argument of wait
+ *
+ * Return: Index in g_global.jobs.list, or -1 if not found
+ */
+static int  find_job(const char *arg)
+{
+    t_job   *job;
+    int     n;
+    int     i;
+    int     j;
+
+    n = ft_atoi(arg + (arg[0] == '%'));
+    i = 0;
+    while (i < g_global.jobs.count)
+    {
+        job = &g_global.jobs.list[i];
+        if (arg[0] == '%' && job->id == n)
+            return (i);
+        j = 0;
+        while (arg[0] != '%' && j < job->npids)
+        {
+            if (n > 0 && (job->pids[j] == n || job->pids[j] == -n))
+                return (i);
+            j++;
+        }
+        i++;
+    }
+    return (-1);
+}
+
+/**
+ * ft_wait - Implement wait builtin
+ * @argv: Command arguments: job specs (%N) or pids; none means all jobs
+ * @argc: Argument count
+ *
+ * Return: Exit status of the last job waited for, 127 for an unknown one
+ */
+int     ft_wait(char **argv, int argc)
+{
+    int status;
+    int index;
+    int i;
+
+    status = 0;
+    if (argc == 1)
+    {
+        while (g_global.jobs.count > 0)
+            status = job_wait(0);
+    }
+    i = 1;
+    while (i < argc)
+    {
+        index = find_job(argv[i]);
+        if (index == -1)
+        {
+            fprintf(stderr, "minishell: wait: %s: no such job\n", argv[i]);
+            status = 127;
+        }
+        else
+            status = job_wait(index);
+        i++;
+    }
+    jobs_reap();
+    g_global.exit_status = status;
+    return (status);
+}
@@ -0,0 +1,423 @@
+/* lexer.c - Quote-aware tokenizer for Minishell */
+/* Author: your_login */
+
+#include "minishell.h"
+
+#define LEX_MIN_TOKENS  16
+
+/*
+ * tokenize_input makes one pass over the line and records each token as a
+ * view (start, len) into it, with its type and the first quote style used
+ * packed into one byte. The fields are kept as parallel columns (t_tokens)
+ * with an explicit count, so the parser's scans over types touch one byte
+ * per token rather than a 40-byte struct, and a token costs 9 bytes.
+ * expand_tokens then gives every word a C string in the str column: words
+ * without quotes or '$' are NUL-terminated in place, and only the others
+ * are unquoted and expanded into the arena.
+ *
+ * The t_token API is kept as a thin adapter over the columns:
+ * tokens_array builds the older NULL-terminated array form and
+ * count_tokens (parser.c) counts it.
+ */
+
+/**
+ * is_blank - Check for a word separator
+ * @c: Character to check
+ *
+ * Return: 1 for space, tab or newline, 0 otherwise
+ */
+static int is_blank(char c)
+{
+    return (c == ' ' || c == '\t' || c == '\n');
+}
+
+/**
+ * is_operator - Check for the first character of an operator
+ * @c: Character to check
+ *
+ * Return: 1 for '|', '<', '>' or '&', 0 otherwise
+ */
+static int is_operator(char c)
+{
+    return (c == '|' || c == '<' || c == '>' || c == '&');
+}
+
+/**
+ * tokens_grow - Double the capacity of every column
+ * @lex: Lexer state
+ *
+ * The columns share one arena block: start, then len, then kind.
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+static int tokens_grow(t_lexer *lex)
+{
+    t_tokens    *ts;
+    size_t      cap;
+    char        *block;
+
+    ts = lex->ts;
+    cap = ts->cap ? ts->cap * 2 : LEX_MIN_TOKENS;
+    block = arena_alloc(lex->arena, cap * (2 * sizeof(uint32_t) + 1));
+    if (!block)
+        return (-1);
+    if (ts->count > 0)
+    {
+        memcpy(block, ts->start, ts->count * sizeof(uint32_t));
+        memcpy(block + cap * sizeof(uint32_t), ts->len,
+            ts->count * sizeof(uint32_t));
+        memcpy(block + cap * 2 * sizeof(uint32_t), ts->kind, ts->count);
+    }
+    ts->start = (uint32_t *)block;
+    ts->len = (uint32_t *)(block + cap * sizeof(uint32_t));
+    ts->kind = (uint8_t *)(block + cap * 2 * sizeof(uint32_t));
+    ts->cap = cap;
+    return (0);
+}
+
+/**
+ * push_token - Append a token, growing the columns if needed
+ * @lex: Lexer state
+ * @start: Offset of the token in the line
+ * @len: Length of the token
+ * @kind: TOKEN_KIND(type, quote)
+ *
+ * Return: 0 on success, -1 on allocation failure or a line too long for
+ * 32-bit offsets
+ */
+static int  push_token(t_lexer *lex, size_t start, size_t len, uint8_t kind)
+{
+    t_tokens    *ts;
+
+    ts = lex->ts;
+    if (start + len > UINT32_MAX)
+    {
+        fprintf(stderr, "minishell: line too long\n");
+        return (-1);
+    }
+    if (ts->count == ts->cap && tokens_grow(lex) == -1)
+        return (-1);
+    ts->start[ts->count] = (uint32_t)start;
+    ts->len[ts->count] = (uint32_t)len;
+    ts->kind[ts->count] = kind;
+    ts->count++;
+    return (0);
+}
+
+/**
+ * lex_operator - Read an operator token
+ * @lex: Lexer state
+ * @i: Offset of the operator
+ *
+ * Return: Offset just past the operator, or -1 on allocation failure
+ */
+static long lex_operator(t_lexer *lex, size_t i)
+{
+    const char  *s;
+    size_t      len;
+    int         type;
+    
+    s = lex->ts->line;
+    len = 1;
+    if (s[i] == '|')
+        type = TOK_PIPE;
+    else if (s[i] == '&')
+        type = TOK_BACKGROUND;
+    else if (s[i] == '<' && s[i + 1] == '<')
+        type = TOK_HEREDOC;
+    else if (s[i] == '>' && s[i + 1] == '>')
+        type = TOK_REDIR_APPEND;
+    else if (s[i] == '<')
+        type = TOK_REDIR_IN;
+    else
+        type = TOK_REDIR_OUT;
+    if (type == TOK_HEREDOC || type == TOK_REDIR_APPEND)
+        len = 2;
+    if (push_token(lex, i, len, TOKEN_KIND(type, QUOTE_NONE)) == -1)
+        return (-1);
+    return ((long)(i + len));
+}
+
+/**
+ * lex_word - Read a word, including any quoted parts
+ * @lex: Lexer state
+ * @i: Offset of the first character
+ *
+ * Return: Offset just past the word, -1 on allocation failure, -2 on an
+ * unclosed quote
+ */
+static long lex_word(t_lexer *lex, size_t i)
+{
+    const char  *s;
+    long        close;
+    size_t      start;
+    int         quote;
+    
+    s = lex->ts->line;
+    start = i;
+    quote = 0;
+    while (s[i] && !is_blank(s[i]) && !is_operator(s[i]))
+    {
+        close = i;
+        if (s[i] == '\'' || s[i] == '"')
+        {
+            if (!quote && s[i] == '\'')
+                quote = QUOTE_SINGLE;
+            else if (!quote)
+                quote = QUOTE_DOUBLE;
+            close = quote_end(s, i, (size_t)-1);
+        }
+        else if (s[i] == '$' && s[i + 1] == '(')
+            close = subst_end(s, i + 2, (size_t)-1);
+        if (close == -1)
+        {
+            fprintf(stderr, "minishell: unexpected EOF while looking "
+                "for matching `%c'\n", s[i] == '$' ? ')' : s[i]);
+            return (-2);
+        }
+        i = (size_t)close + 1;
+    }
+    if (push_token(lex, start, i - start, TOKEN_KIND(TOK_WORD, quote)) == -1)
+        return (-1);
+    return ((long)i);
+}
+
+/**
+ * detach_line - Move tokens off the input buffer when the line has '<<'
+ * @ts: Token stream with all tokens pushed
+ * @arena: Arena receiving the copy
+ *
+ * Here-document bodies are read from the same input as the line, which
+ * may reuse the buffer holding it, so such a line is copied into the
+ * arena. Tokens are offsets, so only the line pointer changes.
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+static int detach_line(t_tokens *ts, t_arena *arena)
+{
+    char    *copy;
+    size_t  i;
+    
+    i = 0;
+    while (i < ts->count && TOKEN_TYPE(ts->kind[i]) != TOK_HEREDOC)
+        i++;
+    if (i == ts->count)
+        return (0);
+    copy = arena_strndup(arena, ts->line, ft_strlen(ts->line));
+    if (!copy)
+        return (-1);
+    ts->line = copy;
+    return (0);
+}
+
+/**
+ * tokenize_input - Split a command line into tokens
+ * @input: Command line; words are later NUL-terminated in place
+ * @arena: Arena owning the token stream
+ *
+ * Recognises words (with '...', "..." and $(...) parts), |, <, >, >> and
+ * <<.
+ *
+ * Return: Token stream with at least one token, or NULL on an empty line,
+ * syntax error (g_global.exit_status set) or allocation failure
+ */
+t_tokens    *tokenize_input(char *input, t_arena *arena)
+{
+    t_lexer lex;
+    size_t  i;
+    long    next;
+    
+    lex.arena = arena;
+    lex.ts = arena_alloc(arena, sizeof(t_tokens));
+    if (!lex.ts)
+        return (NULL);
+    ft_bzero(lex.ts, sizeof(t_tokens));
+    lex.ts->line = input;
+    
+    i = 0;
+    while (input[i])
+    {
+        if (is_blank(input[i]))
+        {
+            i++;
+            continue;
+        }
+        if (is_operator(input[i]))
+            next = lex_operator(&lex, i);
+        else
+            next = lex_word(&lex, i);
+        if (next < 0)
+        {
+            if (next == -2)
+                g_global.exit_status = 2;
+            return (NULL);
+        }
+        i = (size_t)next;
+    }
+    STAT_ADD(tokens, lex.ts->count);
+    STAT_MAX(tokens_max, lex.ts->count);
+    if (lex.ts->count == 0)
+        return (NULL);
+    if (detach_line(lex.ts, arena) == -1)
+        return (NULL);
+    return (lex.ts);
+}
+
+/**
+ * tokens_skip - Drop tokens from the front of a stream
+ * @ts: Token stream, not yet expanded
+ * @n: Number of tokens to drop, at most ts->count
+ */
+void    tokens_skip(t_tokens *ts, size_t n)
+{
+    ts->start += n;
+    ts->len += n;
+    ts->kind += n;
+    ts->count -= n;
+    ts->cap -= n;
+}
+
+/**
+ * tokens_array - Build the t_token array form of a token stream
+ * @ts: Token stream
+ * @arena: Arena owning the array
+ *
+ * Before expand_tokens, str is a view into the line (not terminated).
+ *
+ * Return: Array of ts->count tokens terminated by a NULL str, or NULL on
+ * allocation failure
+ */
+t_token *tokens_array(const t_tokens *ts, t_arena *arena)
+{
+    t_token *tokens;
+    size_t  i;
+    
+    tokens = arena_alloc(arena, (ts->count + 1) * sizeof(t_token));
+    if (!tokens)
+        return (NULL);
+    i = 0;
+    while (i < ts->count)
+    {
+        tokens[i].str = ts->str ? ts->str[i] : ts->line + ts->start[i];
+        tokens[i].type = TOKEN_TYPE(ts->kind[i]);
+        tokens[i].quote_type = TOKEN_QUOTE(ts->kind[i]);
+        tokens[i].start = ts->start[i];
+        tokens[i].len = ts->len[i];
+        i++;
+    }
+    ft_bzero(&tokens[i], sizeof(t_token));
+    return (tokens);
+}
+
+/**
+ * unquote_word - Remove quotes from a word and expand it
+ * @sb: Buffer receiving the result
+ * @s: Word text
+ * @len: Length of the word
+ * @env: Environment store
+ * @expand: 0 for a here-document delimiter, which only loses its quotes
+ *
+ * Text in single quotes is literal; unquoted and double-quoted text has
+ * variables expanded. The lexer guarantees that every quote is closed.
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+static int unquote_word(t_strbuf *sb, const char *s, size_t len, t_env *env,
+                        int expand)
+{
+    const char  *close;
+    size_t      i;
+    size_t      run;
+    
+    i = 0;
+    while (i < len)
+    {
+        if (s[i] == '\'' || s[i] == '"')
+        {
+            close = s + quote_end(s, i, len);
+            if (((s[i] == '\'' || !expand) && strbuf_append(sb, s + i + 1,
+                    close - (s + i + 1)) == -1)
+                || (s[i] == '"' && expand && expand_append(sb, s + i + 1,
+                    close - (s + i + 1), env) == -1))
+                return (-1);
+            i = close - s + 1;
+            continue;
+        }
+        run = i;
+        while (run < len && s[run] != '\'' && s[run] != '"')
+        {
+            /* Quotes inside $(...) belong to the inner line */
+            if (s[run] == '$' && run + 1 < len && s[run + 1] == '(')
+                run = subst_end(s, run + 2, len);
+            run++;
+        }
+        if ((expand && expand_append(sb, s + i, run - i, env) == -1)
+            || (!expand && strbuf_append(sb, s + i, run - i) == -1))
+            return (-1);
+        i = run;
+    }
+    return (0);
+}
+
+/**
+ * expand_tokens - Give every token a NUL-terminated string
+ * @ts: Token stream from tokenize_input
+ * @env: Environment store
+ * @arena: Arena owning the str column and materialised strings
+ *
+ * Plain words are terminated in place; words with quotes or '$' are
+ * unquoted and expanded into the arena. An unquoted word that expands to
+ * nothing is removed, as in bash.
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+int     expand_tokens(t_tokens *ts, t_env *env, t_arena *arena)
+{
+    t_strbuf    *sb;
+    char        *s;
+    size_t      i;
+    size_t      j;
+    int         prev;
+    
+    sb = &g_global.scratch;
+    ts->str = arena_alloc(arena, (ts->count + 1) * sizeof(char *));
+    if (!ts->str)
+        return (-1);
+    prev = TOK_WORD;
+    i = 0;
+    j = 0;
+    while (i < ts->count)
+    {
+        s = ts->line + ts->start[i];
+        if (TOKEN_TYPE(ts->kind[i]) == TOK_WORD
+            && (TOKEN_QUOTE(ts->kind[i]) != QUOTE_NONE
+                || ft_memchr(s, '$', ts->len[i])))
+        {
+            sb->len = 0;
+            if (unquote_word(sb, s, ts->len[i], env, prev != TOK_HEREDOC)
+                == -1)
+                return (-1);
+            s = NULL;
+            if (sb->len > 0 || TOKEN_QUOTE(ts->kind[i]) != QUOTE_NONE)
+            {
+                s = arena_strndup(arena, sb->data, sb->len);
+                if (!s)
+                    return (-1);
+            }
+        }
+        else if (TOKEN_TYPE(ts->kind[i]) == TOK_WORD)
+            s[ts->len[i]] = '\0';  /* plain word: view into the line */
+        prev = TOKEN_TYPE(ts->kind[i]);
+        if (s)
+        {
+            ts->str[j] = s;
+            ts->start[j] = ts->start[i];
+            ts->len[j] = ts->len[i];
+            ts->kind[j++] = ts->kind[i];
+        }
+        i++;
+    }
+    ts->count = j;
+    ts->str[j] = NULL;
+    return (0);
+}
@@ -13,17 +13,32 @@
  */
 void    *ft_memset(void *b, int c, size_t len)
 {
-    size_t  i;
-    unsigned char   *ptr;
+    SIMD_OPS()->set(b, c, len);
+    return (b);
+}
+
+/**
+ * ft_memchr - Locate byte in memory area
+ * @s: Memory area to search
+ * @c: Byte to find
+ * @n: Number of bytes to search
+ *
+ * Return: Pointer to first occurrence or NULL
+ */
+void    *ft_memchr(const void *s, int c, size_t n)
+{
+    const unsigned char *ptr;
+    size_t              i;
     
-    ptr = (unsigned char *)b;
+    ptr = (const unsigned char *)s;
     i = 0;
-    while (i < len)
+    while (i < n)
     {
-        ptr[i] = (unsigned char)c;
+        if (ptr[i] == (unsigned char)c)
+            return ((void *)&ptr[i]);
         i++;
     }
-    return (b);
+    return (NULL);
 }
 
 /**
@@ -49,6 +64,7 @@ void    *ft_calloc(size_t count, size_t size)
     size_t  total_size;
     
     total_size = count * size;
+    STAT_INC(libft_mallocs);
     ptr = malloc(total_size);
     if (!ptr)
         return (NULL);
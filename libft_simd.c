@@ -0,0 +1,604 @@
+/* libft_simd.c - Word-at-a-time and SSE2/AVX2 kernels for libft */
+/* Author: your_login */
+
+#include "minishell.h"
+#include <stdint.h>
+
+#if defined(__x86_64__)
+# include <immintrin.h>
+# define SIMD_X86   1
+#else
+# define SIMD_X86   0
+#endif
+
+/*
+ * ft_strlen, ft_strchr, ft_strncmp, ft_memset and the word count behind
+ * ft_split call through g_global.simd, picked once at first use: AVX2 if
+ * the CPU has it, else SSE2 (always there on x86_64), else the portable
+ * word-at-a-time (SWAR) code. MINISHELL_SIMD=swar|sse2|avx2 overrides
+ * the choice.
+ *
+ * Kernels that scan for a NUL read whole aligned words or vectors, so a
+ * read never crosses a page boundary even when it runs past the end of
+ * the string; bytes before the start or after the terminator are masked
+ * off. ft_strncmp compares two strings of different alignment with
+ * unaligned loads, and only when neither load can cross a page.
+ *
+ * Those over-reads stay inside mapped pages but do touch bytes outside
+ * the string, so the kernels opt out of AddressSanitizer.
+ */
+
+#define SIMD_PAGE       4096    /* smallest page size we may run on */
+#define ONES            0x0101010101010101ULL
+#define HIGHS           0x8080808080808080ULL
+
+#if defined(__GNUC__)
+# define NO_ASAN        __attribute__((no_sanitize_address))
+#else
+# define NO_ASAN
+#endif
+#if SIMD_X86
+# define AVX2           __attribute__((target("avx2,popcnt")))
+#endif
+
+typedef uint64_t __attribute__((may_alias)) t_word;
+
+/**
+ * load_word - Load an aligned word with the first byte in the low bits
+ * @p: 8-byte aligned address
+ *
+ * Return: The word
+ */
+static inline NO_ASAN uint64_t  load_word(const char *p)
+{
+    uint64_t    w;
+
+    w = *(const t_word *)p;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    w = __builtin_bswap64(w);
+#endif
+    return (w);
+}
+
+/**
+ * zero_bytes - Flag the zero bytes of a word
+ * @w: Word
+ *
+ * Unlike the usual (w - ONES) & ~w & HIGHS test this has no false
+ * positives, so the first flag is the first zero byte.
+ *
+ * Return: 0x80 in every byte of w that is zero, 0 elsewhere
+ */
+static inline uint64_t  zero_bytes(uint64_t w)
+{
+    return (~(((w & ~HIGHS) + ~HIGHS) | w) & HIGHS);
+}
+
+/**
+ * word_mask - Compress zero_bytes() flags into one bit per byte
+ * @hi: Output of zero_bytes()
+ *
+ * Return: Bit i set if byte i was flagged
+ */
+static inline unsigned int  word_mask(uint64_t hi)
+{
+    return ((unsigned int)(((hi >> 7) * 0x0102040810204080ULL) >> 56));
+}
+
+/**
+ * page_safe - Check that an unaligned load stays inside one page
+ * @p: Load address
+ * @width: Load size in bytes
+ *
+ * Return: 1 if safe, 0 otherwise
+ */
+static inline int   page_safe(const char *p, size_t width)
+{
+    return (((uintptr_t)p & (SIMD_PAGE - 1)) <= SIMD_PAGE - width);
+}
+
+/**
+ * count_starts - Count words starting in one chunk of a string
+ * @delim: Bit i set if byte i is the delimiter (or before the string)
+ * @zero: Bit i set if byte i is NUL
+ * @width: Chunk size in bytes (8, 16 or 32)
+ * @carry: In: 1 if the byte before the chunk was in a word. Out: same
+ *         for the last byte of this chunk
+ *
+ * Return: Number of words starting in the chunk
+ */
+static size_t   count_starts(uint32_t delim, uint32_t zero, int width,
+                             uint32_t *carry)
+{
+    uint32_t    valid;
+    uint32_t    word;
+    uint32_t    starts;
+
+    valid = 0xffffffffu;
+    if (width < 32)
+        valid = (1u << width) - 1;
+    if (zero)
+        valid &= (zero & -zero) - 1;
+    word = ~delim & valid;
+    starts = word & ~((word << 1) | *carry);
+    *carry = (word >> (width - 1)) & 1;
+    return (__builtin_popcount(starts));
+}
+
+/**
+ * byte_strncmp - Byte-at-a-time ft_strncmp, used for tails
+ * @s1: First string
+ * @s2: Second string
+ * @n: Number of characters to compare
+ *
+ * Return: Difference between strings or 0 if equal
+ */
+static int  byte_strncmp(const char *s1, const char *s2, size_t n)
+{
+    size_t  i;
+
+    i = 0;
+    while (i < n && s1[i] && s1[i] == s2[i])
+        i++;
+    if (i == n)
+        return (0);
+    return ((unsigned char)s1[i] - (unsigned char)s2[i]);
+}
+
+/* Portable word-at-a-time kernels */
+
+static NO_ASAN size_t   swar_strlen(const char *s)
+{
+    const char  *p;
+    uint64_t    hi;
+
+    p = (const char *)((uintptr_t)s & ~(uintptr_t)7);
+    hi = zero_bytes(load_word(p)) & (~0ULL << ((s - p) * 8));
+    while (!hi)
+    {
+        p += 8;
+        hi = zero_bytes(load_word(p));
+    }
+    return (p + (__builtin_ctzll(hi) >> 3) - s);
+}
+
+static NO_ASAN char *swar_strchr(const char *s, int c)
+{
+    const char  *p;
+    uint64_t    rep;
+    uint64_t    w;
+    uint64_t    hi;
+
+    rep = ONES * (unsigned char)c;
+    p = (const char *)((uintptr_t)s & ~(uintptr_t)7);
+    w = load_word(p);
+    hi = (zero_bytes(w) | zero_bytes(w ^ rep)) & (~0ULL << ((s - p) * 8));
+    while (!hi)
+    {
+        p += 8;
+        w = load_word(p);
+        hi = zero_bytes(w) | zero_bytes(w ^ rep);
+    }
+    p += __builtin_ctzll(hi) >> 3;
+    if (*p == (char)c)
+        return ((char *)p);
+    return (NULL);
+}
+
+static NO_ASAN int  swar_strncmp(const char *s1, const char *s2, size_t n)
+{
+    size_t      i;
+    uint64_t    a;
+
+    i = 0;
+    if ((((uintptr_t)s1 ^ (uintptr_t)s2) & 7) == 0)
+    {
+        /* Same alignment: step to a word boundary, then compare words */
+        while (i < n && ((uintptr_t)(s1 + i) & 7))
+        {
+            if (s1[i] != s2[i] || !s1[i])
+                return ((unsigned char)s1[i] - (unsigned char)s2[i]);
+            i++;
+        }
+        while (n - i >= 8)
+        {
+            a = *(const t_word *)(s1 + i);
+            if (a != *(const t_word *)(s2 + i) || zero_bytes(a))
+                break;
+            i += 8;
+        }
+    }
+    return (byte_strncmp(s1 + i, s2 + i, n - i));
+}
+
+static void swar_memset(void *b, int c, size_t len)
+{
+    unsigned char   *p;
+    uint64_t        rep;
+
+    p = (unsigned char *)b;
+    while (len > 0 && ((uintptr_t)p & 7))
+    {
+        *p++ = (unsigned char)c;
+        len--;
+    }
+    rep = ONES * (unsigned char)c;
+    while (len >= 8)
+    {
+        *(t_word *)p = rep;
+        p += 8;
+        len -= 8;
+    }
+    while (len-- > 0)
+        *p++ = (unsigned char)c;
+}
+
+static NO_ASAN size_t   swar_count_words(const char *s, char delim)
+{
+    const char  *p;
+    uint64_t    rep;
+    uint64_t    w;
+    uint32_t    before;
+    uint32_t    zero;
+    uint32_t    carry;
+    size_t      count;
+
+    rep = ONES * (unsigned char)delim;
+    p = (const char *)((uintptr_t)s & ~(uintptr_t)7);
+    before = (1u << (s - p)) - 1;
+    carry = 0;
+    count = 0;
+    while (1)
+    {
+        w = load_word(p);
+        zero = word_mask(zero_bytes(w)) & ~before;
+        count += count_starts(word_mask(zero_bytes(w ^ rep)) | before,
+                              zero, 8, &carry);
+        if (zero)
+            return (count);
+        before = 0;
+        p += 8;
+    }
+}
+
+#if SIMD_X86
+
+/* SSE2 kernels, 16 bytes per step */
+
+static NO_ASAN size_t   sse2_strlen(const char *s)
+{
+    const __m128i   zero = _mm_setzero_si128();
+    const char      *p;
+    unsigned int    m;
+
+    p = (const char *)((uintptr_t)s & ~(uintptr_t)15);
+    m = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i *)p),
+                                         zero));
+    m &= ~0u << (s - p);
+    while (!m)
+    {
+        p += 16;
+        m = _mm_movemask_epi8(_mm_cmpeq_epi8(
+                    _mm_load_si128((const __m128i *)p), zero));
+    }
+    return (p + __builtin_ctz(m) - s);
+}
+
+static NO_ASAN char *sse2_strchr(const char *s, int c)
+{
+    const __m128i   zero = _mm_setzero_si128();
+    const __m128i   rep = _mm_set1_epi8((char)c);
+    const char      *p;
+    __m128i         v;
+    unsigned int    m;
+
+    p = (const char *)((uintptr_t)s & ~(uintptr_t)15);
+    v = _mm_load_si128((const __m128i *)p);
+    m = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, zero),
+                                       _mm_cmpeq_epi8(v, rep)));
+    m &= ~0u << (s - p);
+    while (!m)
+    {
+        p += 16;
+        v = _mm_load_si128((const __m128i *)p);
+        m = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, zero),
+                                           _mm_cmpeq_epi8(v, rep)));
+    }
+    p += __builtin_ctz(m);
+    if (*p == (char)c)
+        return ((char *)p);
+    return (NULL);
+}
+
+static NO_ASAN int  sse2_strncmp(const char *s1, const char *s2, size_t n)
+{
+    const __m128i   zero = _mm_setzero_si128();
+    __m128i         a;
+    __m128i         b;
+    unsigned int    m;
+    size_t          i;
+
+    i = 0;
+    while (i < n)
+    {
+        if (!page_safe(s1 + i, 16) || !page_safe(s2 + i, 16))
+        {
+            if (s1[i] != s2[i] || !s1[i])
+                return ((unsigned char)s1[i] - (unsigned char)s2[i]);
+            i++;
+            continue;
+        }
+        a = _mm_loadu_si128((const __m128i *)(s1 + i));
+        b = _mm_loadu_si128((const __m128i *)(s2 + i));
+        m = (~_mm_movemask_epi8(_mm_cmpeq_epi8(a, b))
+             | _mm_movemask_epi8(_mm_cmpeq_epi8(a, zero))) & 0xffff;
+        if (n - i < 16)
+            m &= (1u << (n - i)) - 1;
+        if (m)
+        {
+            i += __builtin_ctz(m);
+            return ((unsigned char)s1[i] - (unsigned char)s2[i]);
+        }
+        i += 16;
+    }
+    return (0);
+}
+
+static void sse2_memset(void *b, int c, size_t len)
+{
+    const __m128i   rep = _mm_set1_epi8((char)c);
+    unsigned char   *p;
+
+    p = (unsigned char *)b;
+    while (len >= 16)
+    {
+        _mm_storeu_si128((__m128i *)p, rep);
+        p += 16;
+        len -= 16;
+    }
+    while (len-- > 0)
+        *p++ = (unsigned char)c;
+}
+
+static NO_ASAN size_t   sse2_count_words(const char *s, char delim)
+{
+    const __m128i   zero_v = _mm_setzero_si128();
+    const __m128i   rep = _mm_set1_epi8(delim);
+    const char      *p;
+    __m128i         v;
+    uint32_t        before;
+    uint32_t        zero;
+    uint32_t        carry;
+    size_t          count;
+
+    p = (const char *)((uintptr_t)s & ~(uintptr_t)15);
+    before = (1u << (s - p)) - 1;
+    carry = 0;
+    count = 0;
+    while (1)
+    {
+        v = _mm_load_si128((const __m128i *)p);
+        zero = _mm_movemask_epi8(_mm_cmpeq_epi8(v, zero_v)) & ~before;
+        count += count_starts(_mm_movemask_epi8(_mm_cmpeq_epi8(v, rep))
+                              | before, zero, 16, &carry);
+        if (zero)
+            return (count);
+        before = 0;
+        p += 16;
+    }
+}
+
+/* AVX2 kernels, 32 bytes per step */
+
+static AVX2 NO_ASAN size_t  avx2_strlen(const char *s)
+{
+    const __m256i   zero = _mm256_setzero_si256();
+    const char      *p;
+    unsigned int    m;
+
+    p = (const char *)((uintptr_t)s & ~(uintptr_t)31);
+    m = _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                _mm256_load_si256((const __m256i *)p), zero));
+    m &= ~0u << (s - p);
+    while (!m)
+    {
+        p += 32;
+        m = _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                    _mm256_load_si256((const __m256i *)p), zero));
+    }
+    return (p + __builtin_ctz(m) - s);
+}
+
+static AVX2 NO_ASAN char    *avx2_strchr(const char *s, int c)
+{
+    const __m256i   zero = _mm256_setzero_si256();
+    const __m256i   rep = _mm256_set1_epi8((char)c);
+    const char      *p;
+    __m256i         v;
+    unsigned int    m;
+
+    p = (const char *)((uintptr_t)s & ~(uintptr_t)31);
+    v = _mm256_load_si256((const __m256i *)p);
+    m = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, zero),
+                                             _mm256_cmpeq_epi8(v, rep)));
+    m &= ~0u << (s - p);
+    while (!m)
+    {
+        p += 32;
+        v = _mm256_load_si256((const __m256i *)p);
+        m = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, zero),
+                                                 _mm256_cmpeq_epi8(v, rep)));
+    }
+    p += __builtin_ctz(m);
+    if (*p == (char)c)
+        return ((char *)p);
+    return (NULL);
+}
+
+static AVX2 NO_ASAN int avx2_strncmp(const char *s1, const char *s2, size_t n)
+{
+    const __m256i   zero = _mm256_setzero_si256();
+    __m256i         a;
+    __m256i         b;
+    unsigned int    m;
+    size_t          i;
+
+    i = 0;
+    while (i < n)
+    {
+        if (!page_safe(s1 + i, 32) || !page_safe(s2 + i, 32))
+        {
+            if (s1[i] != s2[i] || !s1[i])
+                return ((unsigned char)s1[i] - (unsigned char)s2[i]);
+            i++;
+            continue;
+        }
+        a = _mm256_loadu_si256((const __m256i *)(s1 + i));
+        b = _mm256_loadu_si256((const __m256i *)(s2 + i));
+        m = ~(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b))
+            | (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, zero));
+        if (n - i < 32)
+            m &= (1u << (n - i)) - 1;
+        if (m)
+        {
+            i += __builtin_ctz(m);
+            return ((unsigned char)s1[i] - (unsigned char)s2[i]);
+        }
+        i += 32;
+    }
+    return (0);
+}
+
+static AVX2 void    avx2_memset(void *b, int c, size_t len)
+{
+    const __m256i   rep = _mm256_set1_epi8((char)c);
+    unsigned char   *p;
+
+    p = (unsigned char *)b;
+    while (len >= 32)
+    {
+        _mm256_storeu_si256((__m256i *)p, rep);
+        p += 32;
+        len -= 32;
+    }
+    while (len-- > 0)
+        *p++ = (unsigned char)c;
+}
+
+static AVX2 NO_ASAN size_t  avx2_count_words(const char *s, char delim)
+{
+    const __m256i   zero_v = _mm256_setzero_si256();
+    const __m256i   rep = _mm256_set1_epi8(delim);
+    const char      *p;
+    __m256i         v;
+    uint32_t        before;
+    uint32_t        zero;
+    uint32_t        carry;
+    size_t          count;
+
+    p = (const char *)((uintptr_t)s & ~(uintptr_t)31);
+    before = (1u << (s - p)) - 1;
+    carry = 0;
+    count = 0;
+    while (1)
+    {
+        v = _mm256_load_si256((const __m256i *)p);
+        zero = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, zero_v)) & ~before;
+        count += count_starts(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, rep))
+                              | before, zero, 32, &carry);
+        if (zero)
+            return (count);
+        before = 0;
+        p += 32;
+    }
+}
+
+#endif
+
+static const t_simd_ops g_simd_ops[SIMD_LEVEL_COUNT] = {
+    {"swar", swar_strlen, swar_strchr, swar_strncmp, swar_memset,
+        swar_count_words},
+#if SIMD_X86
+    {"sse2", sse2_strlen, sse2_strchr, sse2_strncmp, sse2_memset,
+        sse2_count_words},
+    {"avx2", avx2_strlen, avx2_strchr, avx2_strncmp, avx2_memset,
+        avx2_count_words},
+#else
+    {"sse2", NULL, NULL, NULL, NULL, NULL},
+    {"avx2", NULL, NULL, NULL, NULL, NULL},
+#endif
+};
+
+/**
+ * simd_supported - Check whether this CPU can run a kernel level
+ * @level: SIMD_*
+ *
+ * Return: 1 if supported, 0 otherwise
+ */
+int     simd_supported(int level)
+{
+    if (level == SIMD_SWAR)
+        return (1);
+#if SIMD_X86
+    if (level == SIMD_SSE2)
+        return (1);
+    if (level == SIMD_AVX2)
+    {
+        __builtin_cpu_init();
+        return (__builtin_cpu_supports("avx2") != 0);
+    }
+#endif
+    return (0);
+}
+
+/**
+ * simd_select - Switch the libft kernels to a given level
+ * @level: SIMD_*
+ *
+ * Return: 0 on success, -1 if the level is unknown or unsupported
+ */
+int     simd_select(int level)
+{
+    if (level < 0 || level >= SIMD_LEVEL_COUNT || !simd_supported(level))
+        return (-1);
+    g_global.simd = &g_simd_ops[level];
+    return (0);
+}
+
+/**
+ * simd_resolve - Pick the best kernel level for this CPU
+ *
+ * Called on the first libft call; see SIMD_OPS().
+ *
+ * Return: The selected kernels
+ */
+const t_simd_ops    *simd_resolve(void)
+{
+    int level;
+
+    level = SIMD_LEVEL_COUNT - 1;
+    while (!simd_supported(level))
+        level--;
+    simd_select(level);
+    return (g_global.simd);
+}
+
+/**
+ * simd_level_from_name - Parse a kernel level name
+ * @name: "swar", "sse2" or "avx2"
+ *
+ * Return: SIMD_* or -1 if unknown
+ */
+int     simd_level_from_name(const char *name)
+{
+    int i;
+
+    i = 0;
+    while (i < SIMD_LEVEL_COUNT)
+    {
+        if (byte_strncmp(name, g_simd_ops[i].name, (size_t)-1) == 0)
+            return (i);
+        i++;
+    }
+    return (-1);
+}
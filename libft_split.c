@@ -0,0 +1,164 @@
+/* libft_split.c - Single-allocation string splitting */
+/* Author: your_login */
+
+#include "minishell.h"
+
+/*
+ * ft_split and ft_split_set return the pointer table and the field data
+ * in one block: the table comes first, followed by a copy of the source
+ * string with every delimiter run cut by a NUL. A single free() of the
+ * result releases everything, and splitting costs one pass to size the
+ * block and one memcpy.
+ *
+ * t_split_iter walks the same fields as views into the source string,
+ * with no allocation at all.
+ */
+
+#define DELIM_TEST(set, c) \
+    ((set)[(unsigned char)(c) >> 3] & (1 << ((unsigned char)(c) & 7)))
+
+/**
+ * delim_set_init - Build a delimiter bitmap
+ * @set: 256-bit bitmap to fill
+ * @delims: NUL-terminated delimiter characters
+ */
+static void delim_set_init(unsigned char set[32], const char *delims)
+{
+    ft_bzero(set, 32);
+    while (*delims)
+    {
+        set[(unsigned char)*delims >> 3] |= 1 << ((unsigned char)*delims & 7);
+        delims++;
+    }
+}
+
+/**
+ * split_block - Carve a counted string into one allocated block
+ * @s: Source string
+ * @len: Length of s
+ * @words: Number of fields in s
+ * @set: Delimiter bitmap
+ *
+ * Return: NULL-terminated field table, or NULL on allocation failure
+ */
+static char **split_block(const char *s, size_t len, size_t words,
+                          const unsigned char set[32])
+{
+    char    **result;
+    char    *data;
+    size_t  i;
+    size_t  j;
+
+    STAT_INC(libft_mallocs);
+    result = malloc((words + 1) * sizeof(char *) + len + 1);
+    if (!result)
+        return (NULL);
+    data = (char *)(result + words + 1);
+    memcpy(data, s, len + 1);
+    i = 0;
+    j = 0;
+    while (j < words)
+    {
+        while (DELIM_TEST(set, data[i]))
+            i++;
+        result[j++] = data + i;
+        while (data[i] && !DELIM_TEST(set, data[i]))
+            i++;
+        data[i++] = '\0';
+    }
+    result[words] = NULL;
+    return (result);
+}
+
+/**
+ * ft_split_set - Split a string on any of a set of delimiters
+ * @s: String to split
+ * @delims: Delimiter characters, e.g. " \t\n"
+ *
+ * Empty fields are skipped, as in ft_split.
+ *
+ * Return: NULL-terminated array in a single block (free only the array),
+ *         or NULL on failure
+ */
+char    **ft_split_set(char const *s, char const *delims)
+{
+    unsigned char   set[32];
+    size_t          words;
+    size_t          i;
+    int             in_word;
+
+    if (!s || !delims)
+        return (NULL);
+    delim_set_init(set, delims);
+    words = 0;
+    in_word = 0;
+    i = 0;
+    while (s[i])
+    {
+        if (DELIM_TEST(set, s[i]))
+            in_word = 0;
+        else if (!in_word)
+        {
+            in_word = 1;
+            words++;
+        }
+        i++;
+    }
+    return (split_block(s, i, words, set));
+}
+
+/**
+ * ft_split - Split string by delimiter
+ * @s: String to split
+ * @c: Delimiter character
+ *
+ * Return: NULL-terminated array in a single block (free only the array),
+ *         or NULL on failure
+ */
+char    **ft_split(char const *s, char c)
+{
+    unsigned char   set[32];
+    char            delims[2];
+
+    if (!s)
+        return (NULL);
+    delims[0] = c;
+    delims[1] = '\0';
+    delim_set_init(set, delims);
+    return (split_block(s, ft_strlen(s), SIMD_OPS()->count_words(s, c), set));
+}
+
+/**
+ * split_iter_init - Start iterating over the fields of a string
+ * @it: Iterator to set up
+ * @s: String to split; must outlive the iterator
+ * @delims: Delimiter characters
+ */
+void    split_iter_init(t_split_iter *it, const char *s, const char *delims)
+{
+    it->pos = s;
+    delim_set_init(it->set, delims);
+}
+
+/**
+ * split_iter_next - Get the next non-empty field
+ * @it: Iterator
+ * @len: Set to the field length
+ *
+ * Return: Start of the field inside the source string (not
+ *         NUL-terminated), or NULL when there are no more fields
+ */
+const char  *split_iter_next(t_split_iter *it, size_t *len)
+{
+    const char  *start;
+
+    while (*it->pos && DELIM_TEST(it->set, *it->pos))
+        it->pos++;
+    if (!*it->pos)
+        return (NULL);
+    start = it->pos;
+    while (*it->pos && !DELIM_TEST(it->set, *it->pos))
+        it->pos++;
+    *len = it->pos - start;
+    return (start);
+}
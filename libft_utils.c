@@ -11,12 +11,7 @@
  */
 size_t  ft_strlen(const char *s)
 {
-    size_t  len;
-    
-    len = 0;
-    while (s[len])
-        len++;
-    return (len);
+    return (SIMD_OPS()->len(s));
 }
 
 /**
@@ -31,6 +26,7 @@ char    *ft_strdup(const char *s)
     char    *dup;
     
     len = ft_strlen(s) + 1;
+    STAT_INC(libft_mallocs);
     dup = malloc(len);
     if (!dup)
         return (NULL);
@@ -49,18 +45,16 @@ char    *ft_strdup(const char *s)
 size_t  ft_strlcpy(char *dst, const char *src, size_t dstsize)
 {
     size_t  src_len;
-    size_t  i;
+    size_t  copy_len;
     
     src_len = ft_strlen(src);
     if (dstsize == 0)
         return (src_len);
-    i = 0;
-    while (src[i] && i < dstsize - 1)
-    {
-        dst[i] = src[i];
-        i++;
-    }
-    dst[i] = '\0';
+    copy_len = src_len;
+    if (copy_len > dstsize - 1)
+        copy_len = dstsize - 1;
+    memcpy(dst, src, copy_len);
+    dst[copy_len] = '\0';
     return (src_len);
 }
 
@@ -73,18 +67,7 @@ size_t  ft_strlcpy(char *dst, const char *src, size_t dstsize)
  */
 char    *ft_strchr(const char *s, int c)
 {
-    size_t  i;
-    size_t  len;
-    
-    len = ft_strlen(s);
-    i = 0;
-    while (i <= len)
-    {
-        if (s[i] == (char)c)
-            return ((char *)&s[i]);
-        i++;
-    }
-    return (NULL);
+    return (SIMD_OPS()->chr(s, c));
 }
 
 /**
@@ -122,16 +105,5 @@ char    *ft_strrchr(const char *s, int c)
  */
 int     ft_strncmp(const char *s1, const char *s2, size_t n)
 {
-    size_t  i;
-    
-    i = 0;
-    while (i < n && s1[i] && s2[i])
-    {
-        if (s1[i] != s2[i])
-            return ((unsigned char)s1[i] - (unsigned char)s2[i]);
-        i++;
-    }
-    if (i == n)
-        return (0);
-    return ((unsigned char)s1[i] - (unsigned char)s2[i]);
+    return (SIMD_OPS()->ncmp(s1, s2, n));
 }
\ No newline at end of file
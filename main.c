@@ -3,13 +3,23 @@
 
 #include "minishell.h"
 
+#define PIPE_SIZE_MAX   (1 << 30)   /* fits F_SETPIPE_SZ's int argument */
+
 /**
  * setup_signal_handlers - Set up signal handlers
+ *
+ * SIGCHLD is blocked and read from a signalfd, which the line reader
+ * polls so background jobs are reaped while waiting for input.
  */
 void    setup_signal_handlers(void)
 {
     signal(SIGINT, SIG_IGN);
     signal(SIGQUIT, SIG_IGN);
+    if (jobs_init() == 0)
+    {
+        g_global.input.wake_fd = g_global.jobs.sigfd;
+        g_global.input.on_wake = jobs_reap;
+    }
 }
 
 /**
@@ -17,126 +27,241 @@ void    setup_signal_handlers(void)
  */
 void    cleanup_resources(void)
 {
+    input_close(&g_global.input);
     cleanup_globals();
 }
 
 /**
- * read_input - Read input from user
+ * read_input - Read the next command line
+ *
+ * Prints the prompt only in interactive mode; batch input (-c, a script
+ * or a non-terminal stdin) is read without prompts or flushes.
  *
- * Return: Input string or NULL on EOF/error
+ * Return: Line owned by the reader, or NULL on EOF/error
  */
 char    *read_input(void)
 {
-    char    *line;
-    size_t  bufsize;
-    
-    line = NULL;
-    bufsize = 0;
-    
-    printf("minishell> ");
-    fflush(stdout);
-    
-    if (getline(&line, &bufsize, stdin) == -1)
+    jobs_notify();
+    if (g_global.interactive)
     {
-        free(line);
-        return (NULL);
+        printf("minishell> ");
+        fflush(stdout);
     }
-    
-    /* Remove trailing newline */
-    size_t len = ft_strlen(line);
-    if (len > 0 && line[len - 1] == '\n')
-        line[len - 1] = '\0';
-    
-    return (line);
+    return (input_read_line(&g_global.input));
+}
+
+/**
+ * report_mem_stats - Print arena usage for the line just processed
+ */
+static void report_mem_stats(void)
+{
+    fprintf(stderr, "mem-stats: line %lu: arena used %zu, reserved %zu, "
+        "high-water %zu\n", (unsigned long)g_global.line_count,
+        g_global.arena.line_peak, g_global.arena.reserved,
+        g_global.arena.high_water);
+}
+
+/**
+ * is_time_keyword - Check for the 'time' prefix of a line
+ * @ts: Token stream, not yet expanded
+ *
+ * Return: 1 if the first token is an unquoted 'time', 0 otherwise
+ */
+static int  is_time_keyword(t_tokens *ts)
+{
+    return (ts->kind[0] == TOKEN_KIND(TOK_WORD, QUOTE_NONE)
+        && ts->len[0] == 4
+        && ft_strncmp(ts->line + ts->start[0], "time", 4) == 0);
 }
 
 /**
  * process_command - Process a single command line
- * @input: Input command line
- * @env: Environment variable array
+ * @input: Input command line; words are NUL-terminated in place
+ * @env: Environment store
+ *
+ * Everything built for the line lives in g_global.arena and is released
+ * by a single reset at the end.
  */
-void    process_command(char *input, char ***env)
+void    process_command(char *input, t_env *env)
 {
-    t_token *tokens;
-    char    *expanded_input;
+    t_arena         *arena;
+    t_tokens        *tokens;
+    t_cmd           *cmds;
+    int             cmd_count;
+    int             ok;
+    int             timed;
+    t_usage         tm;
+    struct rusage   self;
+    unsigned long   t_line;
+    unsigned long   t_exec;
+    unsigned long   t;
     
     if (!input || ft_strlen(input) == 0)
         return;
     
-    /* Expand environment variables */
-    expanded_input = expand_env_vars(input, *env);
-    if (expanded_input)
-    {
-        free(input);
-        input = expanded_input;
-    }
+    /* Apply changes to PATH directories made by the previous line */
+    pathindex_sync();
+    arena = &g_global.arena;
+    g_global.line_count++;
+    STAT_INC(lines);
+    TRACE_BEGIN(t_line);
     
-    /* Tokenize input */
-    tokens = create_simple_tokenizer(input);
-    if (!tokens)
+    /* Tokenize, then unquote and expand the words that need it */
+    TRACE_BEGIN(t);
+    tokens = tokenize_input(input, arena);
+    TRACE_END("tokenize", t, NULL);
+    cmds = NULL;
+    
+    /* 'time' prefix: everything after it is timed, expansion included */
+    timed = (tokens && is_time_keyword(tokens));
+    if (timed)
     {
-        free(input);
-        return;
+        tokens_skip(tokens, 1);
+        time_begin(&tm, &self);
     }
-    
-    /* For now, execute the first token as a simple command */
-    if (tokens[0].str && !ft_strcmp(tokens[0].str, "exit"))
+    if (tokens)
     {
-        char *exit_args[] = {"exit", NULL};
-        ft_exit(exit_args, 1);
+        TRACE_BEGIN(t);
+        ok = (expand_tokens(tokens, env, arena) == 0);
+        TRACE_END("expand", t, NULL);
+        TRACE_BEGIN(t);
+        if (ok && tokens->count > 0)
+            cmds = parse_tokens(tokens, arena, &cmd_count);
+        TRACE_END("parse", t, NULL);
     }
     
-    /* Create simple command structure */
-    t_cmd *cmd = malloc(sizeof(t_cmd));
-    if (!cmd)
+    /* Execute command */
+    TRACE_BEGIN(t);
+    t_exec = trace_now();
+    if (cmds && cmd_count == 1
+        && (cmds[0].argc == 0 || !cmds[0].background))
+        execute_command(&cmds[0], env);
+    else if (cmds)
+        execute_pipeline(cmds, cmd_count, env);
+    if (cmds)
+        TRACE_END("execute", t, cmds[0].argv[0]);
+    g_global.usage.wall_ns += trace_now() - t_exec;
+    if (timed)
+        time_end(&tm, &self);
+    if (cmds)
+        close_heredocs(cmds, cmd_count);
+    
+    /* Clean up */
+    arena_reset(arena);
+    TRACE_END("line", t_line, NULL);
+    if (g_global.mem_stats)
+        report_mem_stats();
+}
+
+/**
+ * open_input - Choose where command lines come from
+ * @argc: Argument count
+ * @argv: Argument values
+ * @i: Index of the first argument after the options
+ *
+ * Usage: minishell [options] [-c command | script]
+ * Without -c or a script, lines are read from stdin, with a prompt only
+ * when stdin is a terminal.
+ *
+ * Return: 0 on success, -1 on error
+ */
+static int open_input(int argc, char **argv, int i)
+{
+    if (i < argc && ft_strcmp(argv[i], "-c") == 0)
     {
-        free_tokens(tokens);
-        free(input);
-        return;
+        if (i + 1 >= argc)
+        {
+            fprintf(stderr, "minishell: -c: option requires an argument\n");
+            return (-1);
+        }
+        return (input_open_string(&g_global.input, argv[i + 1]));
     }
+    if (i < argc)
+        return (input_open_file(&g_global.input, argv[i]));
+    g_global.interactive = isatty(STDIN_FILENO);
+    return (input_open_fd(&g_global.input, STDIN_FILENO));
+}
+
+/**
+ * parse_pipe_size - Parse the value of --pipe-size=
+ * @s: Value text
+ *
+ * Return: Size in bytes, or -1 unless it is a number from 1 to
+ * PIPE_SIZE_MAX
+ */
+static int parse_pipe_size(const char *s)
+{
+    long    n;
+    int     i;
+
+    n = 0;
+    i = 0;
+    while (s[i] >= '0' && s[i] <= '9' && n <= PIPE_SIZE_MAX)
+        n = n * 10 + (s[i++] - '0');
+    if (i == 0 || s[i] || n < 1 || n > PIPE_SIZE_MAX)
+        return (-1);
+    return ((int)n);
+}
+
+/**
+ * parse_options - Handle command line options
+ * @argc: Argument count
+ * @argv: Argument values
+ *
+ * Return: 0 on success, -1 on an unknown option or unusable input
+ */
+static int parse_options(int argc, char **argv)
+{
+    int     i;
     
-    cmd->argc = 0;
-    cmd->argv = malloc(sizeof(char *));
-    cmd->argv[0] = NULL;
-    cmd->infile = NULL;
-    cmd->outfile = NULL;
-    cmd->append_mode = 0;
-    cmd->pipe_in = 0;
-    cmd->pipe_out = 0;
-    
-    /* Fill command arguments */
-    int i = 0;
-    while (tokens[i].str)
+    i = 1;
+    while (i < argc && argv[i][0] == '-' && ft_strcmp(argv[i], "-c") != 0)
     {
-        char **new_argv = malloc((cmd->argc + 2) * sizeof(char *));
-        if (!new_argv)
-            break;
-        
-        int j = 0;
-        while (j < cmd->argc)
+        if (ft_strcmp(argv[i], "--mem-stats") == 0)
+            g_global.mem_stats = 1;
+        else if (ft_strncmp(argv[i], "--trace=", 8) == 0)
         {
-            new_argv[j] = cmd->argv[j];
-            j++;
+            if (trace_init(argv[i] + 8) == -1)
+                return (-1);
+        }
+        else if (ft_strncmp(argv[i], "--stats-json=", 13) == 0)
+        {
+            if (stats_init(argv[i] + 13) == -1)
+                return (-1);
+        }
+        else if (ft_strncmp(argv[i], "--pipe-size=", 12) == 0)
+        {
+            g_global.pipe_size = parse_pipe_size(argv[i] + 12);
+            if (g_global.pipe_size == -1)
+            {
+                fprintf(stderr, "minishell: %s: invalid option\n", argv[i]);
+                return (-1);
+            }
+        }
+        else if (ft_strcmp(argv[i], "--server") == 0 && i + 1 < argc)
+        {
+            /* Requests bring their own input */
+            g_global.server.socket = argv[i + 1];
+            return (0);
+        }
+        else if (ft_strncmp(argv[i], "--spawn=", 8) == 0)
+        {
+            g_global.spawn_backend = spawn_backend_from_name(argv[i] + 8);
+            if (g_global.spawn_backend == -1)
+            {
+                fprintf(stderr, "minishell: %s: unknown spawn backend\n",
+                    argv[i] + 8);
+                return (-1);
+            }
+        }
+        else
+        {
+            fprintf(stderr, "minishell: %s: invalid option\n", argv[i]);
+            return (-1);
         }
-        new_argv[cmd->argc] = tokens[i].str;
-        new_argv[cmd->argc + 1] = NULL;
-        
-        if (cmd->argv)
-            free(cmd->argv);
-        cmd->argv = new_argv;
-        cmd->argc++;
-        
         i++;
     }
-    
-    /* Execute command */
-    if (cmd->argc > 0)
-        execute_command(cmd, env);
-    
-    /* Clean up */
-    free_cmd(cmd);
-    free_tokens(tokens);
-    free(input);
+    return (open_input(argc, argv, i));
 }
 
 /**
@@ -151,23 +276,43 @@ int     main(int argc, char **argv, char **envp)
 {
     char    *input;
     
-    (void)argc;
-    (void)argv;
+    /* Neither the spawn helper nor the client builds shell state */
+    if (argc == 2 && ft_strcmp(argv[1], "--spawn-helper") == 0)
+        return (helper_main(SPAWN_HELPER_FD));
+    if (argc > 1 && ft_strcmp(argv[1], "--client") == 0)
+        return (client_run(argc, argv));
     
     /* Initialize global variables */
     init_globals(envp);
     
+    if (parse_options(argc, argv) == -1)
+    {
+        cleanup_resources();
+        return (2);
+    }
+    
     /* Set up signal handlers */
     setup_signal_handlers();
     
+    if (g_global.server.socket)
+    {
+        g_global.exit_status = server_run(g_global.server.socket);
+        cleanup_resources();
+        return (g_global.exit_status);
+    }
+    
+    /* Index PATH in the background while the first line is read */
+    pathindex_start(&g_global.env);
+    
     /* Main loop */
     while (1)
     {
         input = read_input();
         if (!input)
         {
-            /* EOF or error */
-            printf("exit\n");
+            /* EOF or error: same message and stream as the exit builtin */
+            if (g_global.interactive)
+                write(STDERR_FILENO, "exit\n", 5);
             break;
         }
         
@@ -175,6 +320,9 @@ int     main(int argc, char **argv, char **envp)
     }
     
     /* Clean up */
+    if (g_global.mem_stats)
+        fprintf(stderr, "mem-stats: %lu lines, arena high-water %zu bytes\n",
+            (unsigned long)g_global.line_count, g_global.arena.high_water);
     cleanup_resources();
     
     return (g_global.exit_status);
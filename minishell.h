@@ -14,60 +14,451 @@
 # include <signal.h>
 # include <errno.h>
 # include <string.h>
+# include <stdint.h>
+# include <sys/uio.h>
+# include <sys/resource.h>
+# include <pthread.h>
+
+/* Command hash table (see hash.c) */
+# define CMD_HASH_SIZE 64
+
+typedef struct s_cmd_hash {
+    char                *name;
+    char                *path;  // NULL = cached "command not found"
+    int                 hits;
+    int                 pinned; // set with hash -p, kept by revalidation
+    struct s_cmd_hash   *next;
+}   t_cmd_hash;
+
+/* PATH executable index (see pathindex.c) */
+typedef struct s_pathindex_slot {
+    unsigned int    hash;
+    uint32_t        name;       // offset in names, 0 for an empty slot
+    int             rank;       // first PATH directory holding it, -1 none
+}   t_pathindex_slot;
+
+typedef struct s_pathindex {
+    pthread_t           thread;
+    int                 running;    // builder started, not yet joined
+    int                 ready;      // set by the builder: 1 built, -1 failed
+    int                 cancel;     // asks the builder to stop
+    int                 stale;      // a rebuild is needed
+    pid_t               owner;      // process that started the build
+    int                 fd;         // inotify instance, -1 if none
+    char                **dirs;     // PATH directories, by rank
+    int                 *wds;       // watch per directory, -1 if unwatched
+    int                 ndirs;
+    t_pathindex_slot    *slots;     // open addressing, cap a power of two
+    size_t              cap;
+    size_t              used;
+    char                *names;     // pool of NUL-terminated names
+    size_t              names_len;
+    size_t              names_cap;
+}   t_pathindex;
+
+/* Environment store (see env_store.c) */
+typedef struct s_env_var {
+    char            *str;       // "KEY=VALUE", as passed to execve
+    size_t          key_len;
+    unsigned int    hash;
+}   t_env_var;
+
+typedef struct s_env {
+    t_env_var       *vars;      // dense array, no holes
+    size_t          count;
+    size_t          cap;
+    int             *slots;     // open-addressing index into vars
+    size_t          slot_cap;   // power of two
+    size_t          slot_used;  // live + deleted slots
+    unsigned long   generation; // bumped on every change
+    char            **envp;     // cached execve array
+    size_t          envp_cap;
+    unsigned long   envp_generation;
+}   t_env;
+
+/* Growable string buffer (see strbuf.c) */
+typedef struct s_strbuf {
+    char    *data;
+    size_t  len;
+    size_t  cap;
+}   t_strbuf;
+
+/* Per-command-line arena (see arena.c) */
+typedef struct s_arena_chunk {
+    struct s_arena_chunk    *next;
+    size_t                  size;
+    size_t                  used;
+    _Alignas(16) char       data[];  // ARENA_ALIGN: padded past the header
+}   t_arena_chunk;
+
+typedef struct s_arena {
+    t_arena_chunk   *chunks;      // current chunk first
+    size_t          reserved;     // total chunk bytes
+    size_t          used;         // bytes handed out since last reset
+    size_t          line_peak;    // bytes used by the previous line
+    size_t          high_water;   // most bytes ever used by one line
+}   t_arena;
+
+/* Line reader (see input.c) */
+typedef struct s_input {
+    int         fd;        // -1 for mapped files and strings
+    char        *buf;
+    size_t      len;       // bytes of valid data in buf
+    size_t      pos;       // start of the next line
+    size_t      cap;
+    int         mapped;    // buf is an mmap of a script file
+    int         eof;
+    t_strbuf    tail;      // copy of a final unterminated mapped line
+    int         wake_fd;   // polled with fd while waiting for input
+    void        (*on_wake)(void); // called when wake_fd is readable
+}   t_input;
+
+/* Process launch backends (see spawn.c) */
+# define SPAWN_FORK             0
+# define SPAWN_POSIX            1
+# define SPAWN_VFORK            2
+# define SPAWN_HELPER           3
+# define SPAWN_BACKEND_COUNT    4
+# define SPAWN_HELPER_FD        3   // the helper's end of its socket
+
+/* Per-phase tracer (see trace.c) */
+typedef struct s_trace_event {
+    const char      *name;
+    unsigned long   start;      // ns, CLOCK_MONOTONIC
+    unsigned long   dur;        // ns
+    char            detail[24];
+}   t_trace_event;
+
+typedef struct s_trace {
+    int             enabled;
+    pid_t           owner;      // only this process writes the file
+    char            *path;
+    t_trace_event   *events;    // ring buffer
+    unsigned long   count;      // events recorded so far
+}   t_trace;
+
+# define TRACE_BEGIN(start) \
+    ((start) = g_global.trace.enabled ? trace_now() : 0)
+# define TRACE_END(name, start, detail) \
+    do { if (g_global.trace.enabled) trace_record(name, start, detail); } while (0)
+
+/* Allocation-free field iterator (see libft_split.c) */
+typedef struct s_split_iter {
+    const char      *pos;
+    unsigned char   set[32];    // delimiter bitmap
+}   t_split_iter;
+
+/* libft kernels (see libft_simd.c) */
+# define SIMD_SWAR          0
+# define SIMD_SSE2          1
+# define SIMD_AVX2          2
+# define SIMD_LEVEL_COUNT   3
+
+typedef struct s_simd_ops {
+    const char  *name;
+    size_t      (*len)(const char *s);
+    char        *(*chr)(const char *s, int c);
+    int         (*ncmp)(const char *s1, const char *s2, size_t n);
+    void        (*set)(void *b, int c, size_t len);
+    size_t      (*count_words)(const char *s, char delim);
+}   t_simd_ops;
+
+# define SIMD_OPS() \
+    (g_global.simd ? g_global.simd : simd_resolve())
+
+/* Builtin output buffer (see outbuf.c) */
+# define OUT_BUF_SIZE   65536
+# define OUT_IOV_MAX    64
+
+typedef struct s_outbuf {
+    int             fd;
+    char            *data;      // staging buffer, never reallocated
+    size_t          len;
+    struct iovec    iov[OUT_IOV_MAX];
+    int             iov_count;
+    t_strbuf        *capture;   // when set, flushes append here instead
+}   t_outbuf;
+
+/* Background jobs (see jobs.c) */
+typedef struct s_job {
+    int     id;
+    pid_t   *pids;      // reaped pids are negated
+    int     npids;
+    int     live;       // processes not reaped yet
+    int     status;     // exit status of the last process
+    char    *cmdline;
+}   t_job;
+
+typedef struct s_jobs {
+    t_job   *list;      // ordered by id
+    int     count;
+    int     cap;
+    int     sigfd;      // signalfd for SIGCHLD, -1 if none
+    pid_t   last_pid;   // $!
+}   t_jobs;
+
+/* Hot-path counters (see stats.c) */
+# define SHELL_STATS(X) \
+    X(lines)            /* command lines processed */ \
+    X(tokens)           /* tokens produced by the lexer */ \
+    X(tokens_max)       /* most tokens in one line */ \
+    X(path_searches)    /* PATH walks by find_executable */ \
+    X(path_stats)       /* stat() calls by find_executable */ \
+    X(hash_hits)        /* command hash table hits */ \
+    X(hash_misses) \
+    X(index_lookups)    /* PATH index lookups */ \
+    X(index_events)     /* directory changes applied to the index */ \
+    X(libft_mallocs)    /* strdup, substr, split, calloc */ \
+    X(strbuf_grows)     /* strbuf (re)allocations */ \
+    X(forks)            /* fork() and vfork() */ \
+    X(spawns)           /* posix_spawn() */ \
+    X(out_writes)       /* writev() calls for builtin output */ \
+    X(out_bytes)        /* bytes written by builtins */
+
+# define STATS_MEMBER(name) unsigned long name;
+
+typedef struct s_stats {
+    SHELL_STATS(STATS_MEMBER)
+}   t_stats;
+
+# ifdef MINISHELL_NO_STATS
+#  define STAT_ADD(name, n)     ((void)0)
+#  define STAT_MAX(name, v)     ((void)0)
+# else
+#  define STAT_ADD(name, n)     (g_global.stats.name += (n))
+#  define STAT_MAX(name, v) \
+    do { if ((unsigned long)(v) > g_global.stats.name) \
+        g_global.stats.name = (v); } while (0)
+# endif
+# define STAT_INC(name)         STAT_ADD(name, 1)
+
+/* Resource accounting (see usage.c) */
+typedef struct s_usage {
+    unsigned long   wall_ns;
+    long            utime_us;
+    long            stime_us;
+    long            maxrss;     // KB, largest single process
+    long            minflt;
+    long            majflt;
+    long            nvcsw;
+    long            nivcsw;
+    long            procs;      // children reaped
+}   t_usage;
+
+/* Command server (see server.c) */
+typedef struct s_server {
+    const char  *socket;    // --server path, NULL when not serving
+    int         listen_fd;
+    int         cache_fd[2];    // workers report resolved commands here
+    int         client_fd;  // worker: connection being served
+    pid_t       worker;     // worker: own pid, 0 in the server
+    char        *path;      // PATH the server's hash table was built for
+}   t_server;
+
+/* Spawn helper process (see spawn_helper.c) */
+typedef struct s_spawn_helper {
+    int             fd;         // socket to the helper, -1 if not running
+    pid_t           pid;        // helper process
+    pid_t           owner;      // process that started it
+    int             failed;     // could not start: use posix_spawn
+    unsigned long   env_gen;    // envp generation the helper holds, 0 = none
+    t_strbuf        req;        // request being built
+}   t_spawn_helper;
+
+/* Write ends held by here-document writer threads (see heredoc.c) */
+typedef struct s_heredoc_writers {
+    pthread_mutex_t lock;
+    int             *fds;
+    size_t          count;
+    size_t          cap;
+    int             ready;      // lock and fork handlers set up
+}   t_heredoc_writers;
 
 /* Global variables - only one allowed */
 typedef struct s_global {
-    int     exit_status;
-    char    **env;
+    int         exit_status;
+    t_env       env;
+    t_cmd_hash  *cmd_hash[CMD_HASH_SIZE];
+    t_pathindex pathindex;    // executables on PATH, kept fresh by inotify
+    t_arena     arena;
+    t_strbuf    scratch;      // reused expansion buffer
+    int         mem_stats;    // --mem-stats
+    int         pipe_size;    // --pipe-size, 0 = kernel default
+    int         spawn_backend; // SPAWN_*, see --spawn
+    t_spawn_helper  helper;   // --spawn=helper launcher
+    size_t      line_count;
+    t_input     input;        // where command lines come from
+    int         interactive;  // prompt and "exit" on EOF
+    t_trace     trace;        // --trace / MINISHELL_TRACE
+    t_outbuf    out;          // builtin output
+    const t_simd_ops *simd;   // libft kernels, NULL until first use
+    t_jobs      jobs;         // background jobs
+    t_heredoc_writers   heredoc_writers; // pipe fallback writer threads
+    t_server    server;       // --server state
+    t_usage     usage;        // every child reaped this session
+    t_usage     *timing;      // active 'time' prefix, or NULL
+    t_stats     stats;        // hot-path counters
+    char        *stats_json;  // --stats-json file, NULL if off
+    pid_t       stats_owner;  // process that writes stats_json
 }   t_global;
 
-/* Command structures */
+/* Token types */
+# define TOK_WORD           0
+# define TOK_PIPE           1
+# define TOK_REDIR_IN       2
+# define TOK_REDIR_OUT      3
+# define TOK_REDIR_APPEND   4
+# define TOK_HEREDOC        5
+# define TOK_BACKGROUND     6
+
+/* Token quote styles */
+# define QUOTE_NONE         0
+# define QUOTE_SINGLE       1
+# define QUOTE_DOUBLE       2
+
+/* Packed token kind: TOK_* in the low nibble, QUOTE_* in the high one */
+# define TOKEN_KIND(type, quote)    ((uint8_t)((type) | (quote) << 4))
+# define TOKEN_TYPE(kind)           ((kind) & 0x0f)
+# define TOKEN_QUOTE(kind)          ((kind) >> 4)
+
+/* Token stream (see lexer.c): one column per field, count entries each */
+typedef struct s_tokens {
+    char        *line;      // text the offsets refer to
+    uint32_t    *start;     // offset of each token in line
+    uint32_t    *len;       // length of each token in line
+    uint8_t     *kind;      // TOKEN_KIND(type, quote)
+    char        **str;      // C strings, NULL until expand_tokens
+    size_t      count;
+    size_t      cap;
+}   t_tokens;
+
+/* One token as a struct, for callers that want an array (tokens_array) */
 typedef struct s_token {
-    char    *str;
-    int     type;  // 0=word, 1=pipe, 2=redirection_in, 3=redirection_out, 4=redirection_append
-    int     quote_type;  // 0=none, 1=single, 2=double
+    char    *str;         // view into the line until expand_tokens
+    int     type;         // TOK_*
+    int     quote_type;   // QUOTE_*, first quote style in the word
+    size_t  start;        // offset in the line
+    size_t  len;          // length in the line
 }   t_token;
 
+/* Lexer state (see lexer.c) */
+typedef struct s_lexer {
+    t_tokens    *ts;
+    t_arena     *arena;
+}   t_lexer;
+
+typedef struct s_builtin t_builtin;
+
+/* One redirection of a command, kept in command line order */
+typedef struct s_redir {
+    int     type;   // TOK_REDIR_IN, TOK_REDIR_OUT, TOK_REDIR_APPEND, TOK_HEREDOC
+    char    *file;  // NULL for a here-document (its body is in heredoc_fd)
+}   t_redir;
+
 typedef struct s_cmd {
     char    **argv;
     int     argc;
-    char    *infile;
-    char    *outfile;
-    int     append_mode;  // 0=overwrite, 1=append
-    int     pipe_in;
-    int     pipe_out;
+    const t_builtin *builtin;  // resolved once by the parser, NULL if external
+    t_redir *redirs;   // redirections in command line order
+    int     nredirs;
+    int     pipe_in;   // fd to use as stdin, -1 for none
+    int     pipe_out;  // fd to use as stdout, -1 for none
+    int     pipe_err;  // fd to use as stderr, -1 for none
+    int     redir_in;  // last input file, opened; -1 for none
+    int     redir_out; // last output file, opened; -1 for none
+    int     heredoc_fd; // here-document body to use as stdin, -1 for none
+    int     background; // line ended with '&'
 }   t_cmd;
 
+/* Builtin registry (see builtin_table.c) */
+# define BUILTIN_PARENT     1   // changes shell state
+# define BUILTIN_PIPE_SAFE  2   // only writes output
+
+typedef int (*t_builtin_fn)(t_cmd *cmd, t_env *env);
+
+struct s_builtin {
+    const char      *name;
+    t_builtin_fn    fn;
+    int             flags;
+};
+
 /* Builtin functions */
 int     ft_echo(char **argv, int argc);
 int     ft_cd(char **argv, int argc);
 int     ft_pwd(void);
-int     ft_export(char **argv, int argc, char ***env);
-int     ft_unset(char **argv, int argc, char ***env);
-int     ft_env(char **env);
+int     ft_export(char **argv, int argc, t_env *env);
+int     ft_unset(char **argv, int argc, t_env *env);
+int     ft_env(t_env *env);
 int     ft_exit(char **argv, int argc);
+int     ft_hash(char **argv, int argc, t_env *env);
+int     ft_jobs(void);
+int     ft_wait(char **argv, int argc);
+int     ft_parallel(t_cmd *cmd, t_env *env);
+int     ft_times(char **argv, int argc);
+int     ft_shellstats(char **argv, int argc);
 
 /* Command parsing and execution */
-t_token *tokenize_input(char *input);
-t_cmd   *parse_tokens(t_token *tokens);
-void    execute_command(t_cmd *cmd, char ***env);
-void    execute_pipeline(t_cmd *cmd_list, int cmd_count, char ***env);
+t_tokens    *tokenize_input(char *input, t_arena *arena);
+void    tokens_skip(t_tokens *ts, size_t n);
+t_token *tokens_array(const t_tokens *ts, t_arena *arena);
+t_cmd   *parse_tokens(t_tokens *ts, t_arena *arena, int *cmd_count);
+void    execute_command(t_cmd *cmd, t_env *env);
+void    execute_pipeline(t_cmd *cmd_list, int cmd_count, t_env *env);
+int     exit_status_from_wait(int status);
+pid_t   spawn_command(t_cmd *cmd, const char *path, char **envp);
+int     spawn_backend_from_name(const char *name);
+const char  *spawn_backend_name(int backend);
+void    spawn_child_exec(t_cmd *cmd, const char *path, char **envp);
+pid_t   helper_spawn(t_cmd *cmd, const char *path, char **envp);
+void    helper_stop(void);
+int     helper_main(int fd);
+
+/* Command substitution */
+int     subst_append(t_strbuf *sb, const char *text, size_t len, t_env *env);
+long    subst_end(const char *s, size_t i, size_t len);
+long    quote_end(const char *s, size_t i, size_t len);
 
 /* Environment variable handling */
-char    *expand_env_vars(char *str, char **env);
-char    *get_env_value(char *key, char **env);
-void    set_env_value(char *key, char *value, char ***env);
+int     expand_append(t_strbuf *sb, const char *str, size_t len, t_env *env);
+char    *get_env_value(char *key, t_env *env);
+void    set_env_value(char *key, char *value, t_env *env);
+void    unset_env_value(char *key, t_env *env);
+int     env_init(t_env *env, char **envp);
+void    env_destroy(t_env *env);
+char    *env_get(t_env *env, const char *key, size_t key_len);
+int     env_set(t_env *env, const char *key, const char *value);
+int     env_unset(t_env *env, const char *key);
+char    **env_envp(t_env *env);
+
+/* Command hash table */
+char    *hash_lookup(const char *name, int *found);
+int     hash_insert(const char *name, const char *path);
+int     hash_remove(const char *name);
+void    hash_flush(void);
+int     hash_pin(const char *name, const char *path);
+void    hash_forget(const char *name);
+unsigned int    hash_string(const char *s, size_t len);
+
+/* PATH index */
+void    pathindex_start(t_env *env);
+void    pathindex_stop(void);
+int     pathindex_sync(void);
+int     pathindex_warming(void);
+int     pathindex_resolve(const char *name, char **path, int *volatile_dirs);
 
 /* Redirection handling */
 int     setup_redirections(t_cmd *cmd);
-void    cleanup_redirections(int old_stdin, int old_stdout);
+void    cleanup_redirections(t_cmd *cmd);
+int     redirect_open(t_cmd *cmd);
+void    redirect_close(t_cmd *cmd);
+int     heredoc_open(const char *delim, int quoted, t_env *env);
+void    close_heredocs(t_cmd *cmds, int count);
 
 /* Builtin utilities */
 int     is_builtin(char *cmd);
-char    *find_executable(char *cmd, char **env);
+const t_builtin *find_builtin(const char *name);
+char    *find_executable(char *cmd, t_env *env);
 int     count_tokens(t_token *tokens);
-void    free_tokens(t_token *tokens);
-void    free_cmd(t_cmd *cmd);
 
 /* Memory management */
 void    *ft_calloc(size_t count, size_t size);
@@ -75,11 +466,14 @@ void    ft_free(void **ptr);
 
 /* String utilities (from libft) */
 size_t  ft_strlen(const char *s);
-char    *ft_strjoin(char const *s1, char const *s2);
 char    *ft_strdup(const char *s);
 char    **ft_split(char const *s, char c);
+char    **ft_split_set(char const *s, char const *delims);
+void    split_iter_init(t_split_iter *it, const char *s, const char *delims);
+const char  *split_iter_next(t_split_iter *it, size_t *len);
 int     ft_atoi(const char *str);
 void    *ft_memset(void *b, int c, size_t len);
+void    *ft_memchr(const void *s, int c, size_t n);
 void    ft_bzero(void *s, size_t n);
 char    *ft_strchr(const char *s, int c);
 char    *ft_strrchr(const char *s, int c);
@@ -89,12 +483,82 @@ size_t  ft_strlcpy(char *dst, const char *src, size_t dstsize);
 char    *ft_substr(char const *s, unsigned int start, size_t len);
 int     ft_isalnum(int c);
 
+/* libft kernel dispatch */
+int     simd_supported(int level);
+int     simd_select(int level);
+const t_simd_ops    *simd_resolve(void);
+int     simd_level_from_name(const char *name);
+
+/* Growable string buffer */
+void    strbuf_init(t_strbuf *sb);
+int     strbuf_reserve(t_strbuf *sb, size_t extra);
+int     strbuf_append(t_strbuf *sb, const char *s, size_t n);
+int     strbuf_putc(t_strbuf *sb, char c);
+int     strbuf_putnbr(t_strbuf *sb, long n);
+char    *strbuf_detach(t_strbuf *sb);
+void    strbuf_free(t_strbuf *sb);
+
+/* Line reader */
+int     input_open_fd(t_input *in, int fd);
+int     input_open_string(t_input *in, const char *s);
+int     input_open_file(t_input *in, const char *path);
+char    *input_read_line(t_input *in);
+void    input_close(t_input *in);
+int     read_full(int fd, void *buf, size_t len);
+
+/* Builtin output */
+int     out_init(t_outbuf *out, int fd);
+void    out_destroy(t_outbuf *out);
+int     out_flush(t_outbuf *out);
+int     out_write(t_outbuf *out, const char *s, size_t n);
+int     out_str(t_outbuf *out, const char *s);
+int     out_putc(t_outbuf *out, char c);
+int     builtin_flush(const char *name);
+
+/* Background jobs */
+int     jobs_init(void);
+void    jobs_destroy(void);
+int     job_add(pid_t *pids, int npids, t_cmd *cmds, int count);
+void    jobs_reap(void);
+void    jobs_notify(void);
+
+/* Command server */
+int     server_run(const char *path);
+int     client_run(int argc, char **argv);
+
+/* Main loop */
+char    *read_input(void);
+void    process_command(char *input, t_env *env);
+
+/* Resource accounting */
+pid_t   wait_child(pid_t pid, int *status, int options);
+void    time_begin(t_usage *tm, struct rusage *self);
+void    time_end(t_usage *tm, struct rusage *self);
+
+/* Hot-path counters */
+int     stats_init(const char *path);
+int     stats_format(t_strbuf *sb, int json);
+void    stats_flush(void);
+
+/* Tracing */
+int     trace_init(const char *path);
+unsigned long   trace_now(void);
+void    trace_record(const char *name, unsigned long start, const char *detail);
+void    trace_flush(void);
+
 /* Global management */
 void    init_globals(char **envp);
 void    cleanup_globals(void);
 
-/* Simple parser */
-t_token *create_simple_tokenizer(char *input);
+/* Lexer */
+int     expand_tokens(t_tokens *ts, t_env *env, t_arena *arena);
+
+/* Arena allocator */
+int     arena_init(t_arena *arena, size_t size);
+void    *arena_alloc(t_arena *arena, size_t size);
+char    *arena_strndup(t_arena *arena, const char *s, size_t n);
+void    arena_reset(t_arena *arena);
+void    arena_destroy(t_arena *arena);
 
 /* External global variable */
 extern t_global g_global;
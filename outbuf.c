@@ -0,0 +1,189 @@
+/* outbuf.c - Buffered, syscall-minimal output for builtins */
+/* Author: your_login */
+
+#include "minishell.h"
+
+#define OUT_DIRECT_MIN  1024    /* longer pieces are referenced, not copied */
+
+/*
+ * Builtins write through g_global.out instead of stdio. Short pieces are
+ * copied into a fixed staging buffer; long ones are referenced in place.
+ * Both are queued as iovecs and sent with a single writev when the
+ * builtin finishes (out_flush), or earlier if the buffer fills up. So
+ * echo with any number of arguments is one syscall, and env on a
+ * thousand-variable environment is one writev.
+ *
+ * The staging buffer never moves, so queued iovecs stay valid. Callers
+ * must keep referenced strings alive until the next flush, which every
+ * builtin does by flushing before it returns.
+ *
+ * With out->capture set, flushing appends to that buffer instead of
+ * writing; command substitution runs pure builtins this way (subst.c).
+ */
+
+/**
+ * out_init - Set up the output buffer
+ * @out: Output buffer
+ * @fd: Descriptor to write to
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+int     out_init(t_outbuf *out, int fd)
+{
+    ft_bzero(out, sizeof(t_outbuf));
+    out->fd = fd;
+    out->data = malloc(OUT_BUF_SIZE);
+    if (!out->data)
+        return (-1);
+    return (0);
+}
+
+/**
+ * out_destroy - Flush and release the output buffer
+ * @out: Output buffer
+ */
+void    out_destroy(t_outbuf *out)
+{
+    out_flush(out);
+    free(out->data);
+    out->data = NULL;
+}
+
+/**
+ * out_flush - Write everything queued with as few syscalls as possible
+ * @out: Output buffer
+ *
+ * Return: 0 on success, -1 on write error (the queue is dropped)
+ */
+int     out_flush(t_outbuf *out)
+{
+    struct iovec    *iov;
+    int             count;
+    ssize_t         n;
+    int             ret;
+    
+    iov = out->iov;
+    count = out->iov_count;
+    ret = 0;
+    while (out->capture && count > 0)
+    {
+        if (strbuf_append(out->capture, iov->iov_base, iov->iov_len) == -1)
+            ret = -1;
+        iov++;
+        count--;
+    }
+    while (count > 0)
+    {
+        n = writev(out->fd, iov, count);
+        STAT_INC(out_writes);
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n == -1)
+        {
+            ret = -1;
+            break;
+        }
+        STAT_ADD(out_bytes, n);
+        /* Skip what was written; resume inside a partly written iovec */
+        while (count > 0 && (size_t)n >= iov->iov_len)
+        {
+            n -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0)
+        {
+            iov->iov_base = (char *)iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+    out->len = 0;
+    out->iov_count = 0;
+    return (ret);
+}
+
+/**
+ * out_write - Queue bytes for output
+ * @out: Output buffer
+ * @s: Bytes to write; kept by reference if long, so they must stay
+ *     valid until the next out_flush
+ * @n: Number of bytes
+ *
+ * Return: 0 on success, -1 on write error while flushing
+ */
+int     out_write(t_outbuf *out, const char *s, size_t n)
+{
+    struct iovec    *last;
+    
+    if (n == 0)
+        return (0);
+    if (out->iov_count == OUT_IOV_MAX
+        || (n < OUT_DIRECT_MIN && out->len + n > OUT_BUF_SIZE))
+    {
+        if (out_flush(out) == -1)
+            return (-1);
+    }
+    if (n >= OUT_DIRECT_MIN)
+    {
+        out->iov[out->iov_count].iov_base = (void *)s;
+        out->iov[out->iov_count].iov_len = n;
+        out->iov_count++;
+        return (0);
+    }
+    memcpy(out->data + out->len, s, n);
+    
+    /* Extend the previous iovec if it ends where this copy starts */
+    last = NULL;
+    if (out->iov_count > 0)
+        last = &out->iov[out->iov_count - 1];
+    if (last && (char *)last->iov_base + last->iov_len == out->data + out->len)
+        last->iov_len += n;
+    else
+    {
+        out->iov[out->iov_count].iov_base = out->data + out->len;
+        out->iov[out->iov_count].iov_len = n;
+        out->iov_count++;
+    }
+    out->len += n;
+    return (0);
+}
+
+/**
+ * out_str - Queue a NUL-terminated string
+ * @out: Output buffer
+ * @s: String (see out_write about lifetime)
+ *
+ * Return: 0 on success, -1 on write error
+ */
+int     out_str(t_outbuf *out, const char *s)
+{
+    return (out_write(out, s, ft_strlen(s)));
+}
+
+/**
+ * out_putc - Queue a single character
+ * @out: Output buffer
+ * @c: Character
+ *
+ * Return: 0 on success, -1 on write error
+ */
+int     out_putc(t_outbuf *out, char c)
+{
+    return (out_write(out, &c, 1));
+}
+
+/**
+ * builtin_flush - Flush a builtin's output and report write errors
+ * @name: Builtin name for the error message
+ *
+ * Return: 0 on success, 1 on write error
+ */
+int     builtin_flush(const char *name)
+{
+    if (out_flush(&g_global.out) == -1)
+    {
+        fprintf(stderr, "%s: write error: %s\n", name, strerror(errno));
+        return (1);
+    }
+    return (0);
+}
@@ -0,0 +1,549 @@
+/* parallel.c - Parallel batch runner builtin for Minishell */
+/* Author: your_login */
+
+#define _GNU_SOURCE
+#include "minishell.h"
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+
+/*
+ * parallel [-j N] CMD [ARG...] [::: INPUT...]
+ *
+ * Runs CMD once per input, at most N at a time (default: one per online
+ * CPU; at most PARALLEL_MAX_SLOTS). Inputs are the words after ':::', or
+ * else the lines of the builtin's stdin. Every '{}' in CMD and its
+ * arguments is replaced by the input; without any '{}' the input is
+ * appended as a last argument.
+ *
+ * Each job writes its stdout and stderr to its own memfd, so a job never
+ * blocks on output and nothing is interleaved. Jobs are reaped as they
+ * finish: the shell waits on its SIGCHLD signalfd and scans the running
+ * slots with wait_child(WNOHANG), as jobs_reap() does. Output is copied out
+ * in input order as soon as every earlier job has been copied; a job is
+ * only started while it is less than PARALLEL_WINDOW * N inputs ahead of
+ * the oldest unfinished one, which bounds the descriptors held open.
+ *
+ * A summary line goes to stderr at the end. The exit status is the
+ * number of failed jobs, capped at 101 as in GNU parallel.
+ */
+
+#define PARALLEL_WINDOW     4
+#define PARALLEL_MAX_FAIL   101
+#define PARALLEL_MAX_SLOTS  1024    /* each running job holds two memfds */
+
+enum e_pjob_state {
+    PJOB_FREE,
+    PJOB_RUNNING,
+    PJOB_DONE
+};
+
+typedef struct s_pjob {
+    pid_t   pid;
+    int     out_fd;
+    int     err_fd;
+    int     status;
+    int     state;      // PJOB_*
+}   t_pjob;
+
+typedef struct s_parallel {
+    char        **tmpl;     // command template
+    int         tmpl_argc;
+    int         has_braces; // some template word contains "{}"
+    char        *path;      // resolved once unless argv[0] has "{}"
+    char        **inputs;   // words after ':::', or NULL to read lines
+    int         input_count;
+    int         next_input;
+    t_input     in;
+    int         devnull;    // stdin of the jobs when reading our stdin
+    t_pjob      *ring;      // PARALLEL_WINDOW * slots entries
+    int         ring_size;
+    int         slots;      // -j N
+    long        started;
+    long        emitted;
+    int         running;
+    long        failed;
+    t_env       *env;
+}   t_parallel;
+
+/**
+ * parallel_usage - Report a usage error
+ *
+ * Return: Always 2
+ */
+static int  parallel_usage(void)
+{
+    fprintf(stderr, "parallel: usage: parallel [-j N] command [arg ...] "
+        "[::: input ...]\n");
+    return (2);
+}
+
+/**
+ * parallel_slots - Parse the N of -j N
+ * @s: Argument text
+ *
+ * Return: Slot count, or -1 (reported) unless it is 1 to PARALLEL_MAX_SLOTS
+ */
+static int  parallel_slots(const char *s)
+{
+    long    n;
+    int     i;
+
+    n = 0;
+    i = 0;
+    while (s[i] >= '0' && s[i] <= '9' && n <= PARALLEL_MAX_SLOTS)
+        n = n * 10 + (s[i++] - '0');
+    if (i == 0 || s[i] || n < 1 || n > PARALLEL_MAX_SLOTS)
+    {
+        fprintf(stderr, "minishell: parallel: -j %s: expected 1 to %d\n", s,
+            PARALLEL_MAX_SLOTS);
+        return (-1);
+    }
+    return ((int)n);
+}
+
+/**
+ * parallel_options - Parse -j and split template from inputs
+ * @p: State to fill
+ * @argv: Builtin arguments
+ * @argc: Argument count
+ *
+ * Return: 0 on success, -1 on a usage error
+ */
+static int  parallel_options(t_parallel *p, char **argv, int argc)
+{
+    int i;
+    int j;
+
+    p->slots = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    i = 1;
+    while (i < argc && argv[i][0] == '-')
+    {
+        if (ft_strcmp(argv[i], "--") == 0)
+        {
+            i++;
+            break;
+        }
+        if (ft_strncmp(argv[i], "-j", 2) != 0)
+            return (-1);
+        if (argv[i][2])
+            p->slots = parallel_slots(argv[i] + 2);
+        else if (++i < argc)
+            p->slots = parallel_slots(argv[i]);
+        else
+            return (-1);
+        if (p->slots == -1)
+            return (-1);
+        i++;
+    }
+    if (p->slots < 1)
+        p->slots = 1;
+    if (p->slots > PARALLEL_MAX_SLOTS)
+        p->slots = PARALLEL_MAX_SLOTS;
+    p->tmpl = argv + i;
+    j = i;
+    while (j < argc && ft_strcmp(argv[j], ":::") != 0)
+        j++;
+    p->tmpl_argc = j - i;
+    if (j < argc)
+    {
+        p->inputs = argv + j + 1;
+        p->input_count = argc - j - 1;
+    }
+    if (p->tmpl_argc == 0)
+        return (-1);
+    j = 0;
+    while (j < p->tmpl_argc && !p->has_braces)
+        p->has_braces = (strstr(p->tmpl[j++], "{}") != NULL);
+    return (0);
+}
+
+/**
+ * next_input - Get the next input
+ * @p: Runner state
+ *
+ * Return: Input text (valid until the next call), or NULL when exhausted
+ */
+static char *next_input(t_parallel *p)
+{
+    if (p->inputs)
+    {
+        if (p->next_input >= p->input_count)
+            return (NULL);
+        return (p->inputs[p->next_input++]);
+    }
+    return (input_read_line(&p->in));
+}
+
+/**
+ * substitute - Replace every "{}" in a template word
+ * @word: Template word
+ * @input: Replacement
+ *
+ * Return: Heap string, or NULL on allocation failure
+ */
+static char *substitute(const char *word, const char *input)
+{
+    t_strbuf    sb;
+    const char  *hit;
+
+    strbuf_init(&sb);
+    while ((hit = strstr(word, "{}")) != NULL)
+    {
+        if (strbuf_append(&sb, word, hit - word) == -1
+            || strbuf_append(&sb, input, ft_strlen(input)) == -1)
+            break;
+        word = hit + 2;
+    }
+    if (strbuf_append(&sb, word, ft_strlen(word)) == -1)
+    {
+        strbuf_free(&sb);
+        return (NULL);
+    }
+    return (strbuf_detach(&sb));
+}
+
+/**
+ * build_argv - Instantiate the template for one input
+ * @p: Runner state
+ * @input: Input text
+ *
+ * Return: NULL-terminated heap argv (free with free_argv), or NULL
+ */
+static char **build_argv(t_parallel *p, const char *input)
+{
+    char    **argv;
+    int     argc;
+    int     i;
+
+    argc = p->tmpl_argc + !p->has_braces;
+    argv = ft_calloc(argc + 1, sizeof(char *));
+    if (!argv)
+        return (NULL);
+    i = 0;
+    while (i < p->tmpl_argc)
+    {
+        argv[i] = substitute(p->tmpl[i], input);
+        if (!argv[i++])
+            return (argv);
+    }
+    if (!p->has_braces)
+        argv[i] = ft_strdup(input);
+    return (argv);
+}
+
+/**
+ * free_argv - Release an argv from build_argv
+ * @argv: Array to free
+ * @argc: Number of entries it may hold
+ */
+static void free_argv(char **argv, int argc)
+{
+    int i;
+
+    i = 0;
+    while (i < argc)
+        free(argv[i++]);
+    free(argv);
+}
+
+/**
+ * start_job - Start the job for one input
+ * @p: Runner state
+ * @job: Free ring entry
+ * @input: Input text
+ *
+ * A job that cannot be started is recorded as finished with status 127,
+ * with the error captured as its stderr.
+ */
+static void start_job(t_parallel *p, t_pjob *job, const char *input)
+{
+    t_cmd   cmd;
+    char    *path;
+    int     argc;
+
+    ft_bzero(&cmd, sizeof(cmd));
+    argc = p->tmpl_argc + !p->has_braces;
+    cmd.argv = build_argv(p, input);
+    cmd.argc = argc;
+    job->out_fd = memfd_create("parallel-out", MFD_CLOEXEC);
+    job->err_fd = memfd_create("parallel-err", MFD_CLOEXEC);
+    job->state = PJOB_DONE;
+    job->status = 127;
+    job->pid = -1;
+    if (!cmd.argv || !cmd.argv[argc - 1] || job->out_fd == -1
+        || job->err_fd == -1)
+    {
+        fprintf(stderr, "parallel: %s\n", strerror(errno));
+        if (cmd.argv)
+            free_argv(cmd.argv, argc);
+        return;
+    }
+    path = p->path;
+    if (!path)
+        path = find_executable(cmd.argv[0], p->env);
+    cmd.pipe_in = p->devnull;
+    cmd.pipe_out = job->out_fd;
+    cmd.pipe_err = job->err_fd;
+    cmd.redir_in = -1;
+    cmd.redir_out = -1;
+    cmd.heredoc_fd = -1;
+    if (!path)
+        dprintf(job->err_fd, "%s: command not found\n", cmd.argv[0]);
+    else
+        job->pid = spawn_command(&cmd, path, env_envp(p->env));
+    if (job->pid > 0)
+    {
+        job->state = PJOB_RUNNING;
+        p->running++;
+    }
+    if (path != p->path)
+        free(path);
+    free_argv(cmd.argv, argc);
+}
+
+/**
+ * copy_output - Copy a job's captured output to a descriptor
+ * @from: memfd holding the output
+ * @to: Destination
+ */
+static void copy_output(int from, int to)
+{
+    char    buf[8192];
+    off_t   off;
+    off_t   size;
+    ssize_t n;
+
+    size = lseek(from, 0, SEEK_END);
+    off = 0;
+    while (off < size)
+    {
+        n = sendfile(to, from, &off, size - off);
+        if (n > 0)
+            continue;
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n == 0 || (errno != EINVAL && errno != ENOSYS))
+            return;
+
+        /* Destination sendfile cannot write to: plain copy */
+        n = pread(from, buf, sizeof(buf), off);
+        if (n <= 0 || write(to, buf, n) != n)
+            return;
+        off += n;
+    }
+}
+
+/**
+ * emit_ready - Copy out finished jobs in input order
+ * @p: Runner state
+ */
+static void emit_ready(t_parallel *p)
+{
+    t_pjob  *job;
+
+    out_flush(&g_global.out);
+    while (p->emitted < p->started)
+    {
+        job = &p->ring[p->emitted % p->ring_size];
+        if (job->state != PJOB_DONE)
+            return;
+        if (job->out_fd >= 0)
+        {
+            copy_output(job->out_fd, g_global.out.fd);
+            close(job->out_fd);
+        }
+        if (job->err_fd >= 0)
+        {
+            copy_output(job->err_fd, STDERR_FILENO);
+            close(job->err_fd);
+        }
+        if (job->status != 0)
+            p->failed++;
+        job->state = PJOB_FREE;
+        p->emitted++;
+    }
+}
+
+/**
+ * reap_jobs - Collect finished jobs, blocking until at least one is done
+ * @p: Runner state with at least one running job
+ */
+static void reap_jobs(t_parallel *p)
+{
+    struct pollfd   pfd;
+    t_pjob          *job;
+    int             reaped;
+    int             status;
+    long            i;
+
+    reaped = 0;
+    while (!reaped)
+    {
+        i = p->emitted;
+        while (i < p->started)
+        {
+            job = &p->ring[i++ % p->ring_size];
+            if (job->state == PJOB_RUNNING
+                && wait_child(job->pid, &status, WNOHANG) == job->pid)
+            {
+                job->status = exit_status_from_wait(status);
+                job->state = PJOB_DONE;
+                p->running--;
+                reaped++;
+            }
+        }
+        if (reaped)
+            return;
+        if (g_global.jobs.sigfd < 0)
+        {
+            /* No signalfd: block on the oldest running job */
+            job = &p->ring[p->emitted % p->ring_size];
+            i = p->emitted;
+            while (job->state != PJOB_RUNNING)
+                job = &p->ring[++i % p->ring_size];
+            if (wait_child(job->pid, &status, 0) == job->pid)
+            {
+                job->status = exit_status_from_wait(status);
+                job->state = PJOB_DONE;
+                p->running--;
+                return;
+            }
+            continue;
+        }
+        pfd.fd = g_global.jobs.sigfd;
+        pfd.events = POLLIN;
+        poll(&pfd, 1, -1);
+
+        /* Drains the signalfd; background jobs are reaped on the way */
+        jobs_reap();
+    }
+}
+
+/**
+ * parallel_run - Schedule every input over the slots
+ * @p: Runner state
+ */
+static void parallel_run(t_parallel *p)
+{
+    char    *input;
+    int     more;
+
+    more = 1;
+    while (more || p->running > 0)
+    {
+        while (more && p->running < p->slots
+            && p->started - p->emitted < p->ring_size)
+        {
+            input = next_input(p);
+            if (!input)
+            {
+                more = 0;
+                break;
+            }
+            start_job(p, &p->ring[p->started % p->ring_size], input);
+            p->started++;
+        }
+        if (p->running > 0)
+            reap_jobs(p);
+        emit_ready(p);
+    }
+}
+
+/**
+ * parallel_report - Print the summary line
+ * @p: Runner state
+ * @start: trace_now() when the first job was started
+ */
+static void parallel_report(t_parallel *p, unsigned long start)
+{
+    double  secs;
+
+    secs = (trace_now() - start) / 1e9;
+    fprintf(stderr, "parallel: %ld jobs, %ld failed, %d slots, %.3fs",
+        p->started, p->failed, p->slots, secs);
+    if (secs > 0)
+        fprintf(stderr, ", %.1f jobs/s", p->started / secs);
+    fprintf(stderr, "\n");
+}
+
+/**
+ * parallel_main - Set up inputs and command, then run every job
+ * @p: Runner state with options parsed
+ * @cmd: The builtin's command, for its input redirections
+ *
+ * Return: Exit status of the builtin
+ */
+static int  parallel_main(t_parallel *p, t_cmd *cmd)
+{
+    unsigned long   start;
+    int             fd;
+
+    p->ring_size = p->slots * PARALLEL_WINDOW;
+    p->ring = ft_calloc(p->ring_size, sizeof(t_pjob));
+    if (!p->ring)
+    {
+        fprintf(stderr, "minishell: parallel: %s\n", strerror(errno));
+        return (1);
+    }
+    if (!p->inputs)
+    {
+        fd = STDIN_FILENO;
+        if (cmd->heredoc_fd >= 0)
+            fd = cmd->heredoc_fd;
+        if (cmd->redir_in >= 0)
+            fd = cmd->redir_in;
+        if (input_open_fd(&p->in, fd) == -1)
+        {
+            fprintf(stderr, "minishell: parallel: %s\n", strerror(errno));
+            return (1);
+        }
+        p->devnull = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    }
+
+    /* A fixed command name is resolved once, through the hash table */
+    if (!strstr(p->tmpl[0], "{}"))
+    {
+        p->path = find_executable(p->tmpl[0], p->env);
+        if (!p->path)
+        {
+            fprintf(stderr, "%s: command not found\n", p->tmpl[0]);
+            return (127);
+        }
+    }
+    start = trace_now();
+    parallel_run(p);
+    parallel_report(p, start);
+    if (p->failed > PARALLEL_MAX_FAIL)
+        return (PARALLEL_MAX_FAIL);
+    return ((int)p->failed);
+}
+
+/**
+ * ft_parallel - Implement parallel builtin
+ * @cmd: Command; its input redirection or here-document supplies the
+ *       inputs when there is no ':::'
+ * @env: Environment store
+ *
+ * Return: Number of failed jobs (at most 101), 2 on a usage error
+ */
+int     ft_parallel(t_cmd *cmd, t_env *env)
+{
+    t_parallel  p;
+    int         status;
+
+    ft_bzero(&p, sizeof(p));
+    p.env = env;
+    p.devnull = -1;
+    if (parallel_options(&p, cmd->argv, cmd->argc) == -1)
+        status = parallel_usage();
+    else
+        status = parallel_main(&p, cmd);
+    input_close(&p.in);
+    if (p.devnull >= 0)
+        close(p.devnull);
+    free(p.path);
+    free(p.ring);
+    g_global.exit_status = status;
+    return (status);
+}
@@ -20,121 +20,286 @@ int     count_tokens(t_token *tokens)
 }
 
 /**
- * free_tokens - Free token array
- * @tokens: Token array to free
+ * token_name - Text of a token for error messages
+ * @ts: Token stream
+ * @i: Token index; ts->count stands for the end of the line
+ *
+ * Return: Operator text, word text or "newline"
  */
-void    free_tokens(t_token *tokens)
+static const char *token_name(t_tokens *ts, size_t i)
 {
-    int     i;
+    static const char   *names[] = {NULL, "|", "<", ">", ">>", "<<", "&"};
     
-    if (!tokens)
-        return;
+    if (i >= ts->count)
+        return ("newline");
+    if (TOKEN_TYPE(ts->kind[i]) != TOK_WORD)
+        return (names[TOKEN_TYPE(ts->kind[i])]);
+    return (ts->str[i]);
+}
+
+/**
+ * syntax_error - Report an unexpected token
+ * @ts: Token stream
+ * @i: Index of the offending token
+ *
+ * Return: Always NULL, for use in return statements
+ */
+static t_cmd *syntax_error(t_tokens *ts, size_t i)
+{
+    fprintf(stderr, "minishell: syntax error near unexpected token `%s'\n",
+        token_name(ts, i));
+    g_global.exit_status = 2;
+    return (NULL);
+}
+
+/**
+ * is_redirection - Check for a redirection operator
+ * @type: Token type
+ *
+ * Return: 1 for <, >, >> and <<, 0 otherwise
+ */
+static int is_redirection(int type)
+{
+    return (type == TOK_REDIR_IN || type == TOK_REDIR_OUT
+        || type == TOK_REDIR_APPEND || type == TOK_HEREDOC);
+}
+
+/**
+ * add_redirection - Append a redirection to a command
+ * @cmd: Command being built; redirs has room for every redirection
+ * @ts: Token stream
+ * @i: Index of the redirection; the file name follows it
+ *
+ * Files are only recorded here and opened in order when the command runs
+ * (redirect_open). A here-document body is read from the shell input
+ * right here.
+ *
+ * Return: 0 on success, -1 on error
+ */
+static int add_redirection(t_cmd *cmd, t_tokens *ts, size_t i)
+{
+    t_redir *r;
     
-    i = 0;
-    while (tokens[i].str)
+    r = &cmd->redirs[cmd->nredirs++];
+    r->type = TOKEN_TYPE(ts->kind[i]);
+    r->file = ts->str[i + 1];
+    if (r->type == TOK_HEREDOC)
     {
-        free(tokens[i].str);
-        i++;
+        /* Only the last here-document can be stdin */
+        close_heredocs(cmd, 1);
+        r->file = NULL;
+        cmd->heredoc_fd = heredoc_open(ts->str[i + 1],
+            TOKEN_QUOTE(ts->kind[i + 1]) != QUOTE_NONE, &g_global.env);
+        if (cmd->heredoc_fd == -1)
+            return (-1);
     }
-    free(tokens);
+    return (0);
 }
 
 /**
- * free_cmd - Free command structure
- * @cmd: Command to free
+ * parse_command - Build one command from the tokens up to the next pipe
+ * @cmd: Command to fill
+ * @ts: Token stream
+ * @first: Index of the command's first token
+ * @arena: Arena owning argv and redirs
+ *
+ * Return: Number of tokens consumed (excluding the pipe), or -1 on error
  */
-void    free_cmd(t_cmd *cmd)
+static int parse_command(t_cmd *cmd, t_tokens *ts, size_t first,
+                         t_arena *arena)
 {
-    int     i;
+    size_t  i;
+    int     words;
+    int     redirs;
     
-    if (!cmd)
-        return;
+    cmd->redirs = NULL;
+    cmd->nredirs = 0;
+    cmd->pipe_in = -1;
+    cmd->pipe_out = -1;
+    cmd->pipe_err = -1;
+    cmd->redir_in = -1;
+    cmd->redir_out = -1;
+    cmd->heredoc_fd = -1;
     
-    if (cmd->argv)
+    /* Count arguments, checking each redirection has a file name */
+    words = 0;
+    redirs = 0;
+    i = first;
+    while (i < ts->count && TOKEN_TYPE(ts->kind[i]) != TOK_PIPE)
     {
-        i = 0;
-        while (cmd->argv[i])
+        if (is_redirection(TOKEN_TYPE(ts->kind[i])))
         {
-            free(cmd->argv[i]);
+            if (i + 1 >= ts->count
+                || TOKEN_TYPE(ts->kind[i + 1]) != TOK_WORD)
+            {
+                syntax_error(ts, i + 1);
+                return (-1);
+            }
+            redirs++;
             i++;
         }
-        free(cmd->argv);
+        else
+            words++;
+        i++;
     }
     
-    if (cmd->infile)
-        free(cmd->infile);
-    if (cmd->outfile)
-        free(cmd->outfile);
-    
-    free(cmd);
+    cmd->argv = arena_alloc(arena, (words + 1) * sizeof(char *));
+    if (!cmd->argv)
+        return (-1);
+    if (redirs > 0)
+    {
+        cmd->redirs = arena_alloc(arena, redirs * sizeof(t_redir));
+        if (!cmd->redirs)
+            return (-1);
+    }
+    cmd->argc = 0;
+    i = first;
+    while (i < ts->count && TOKEN_TYPE(ts->kind[i]) != TOK_PIPE)
+    {
+        if (is_redirection(TOKEN_TYPE(ts->kind[i])))
+        {
+            if (add_redirection(cmd, ts, i) == -1)
+                return (-1);
+            i++;
+        }
+        else
+            cmd->argv[cmd->argc++] = ts->str[i];
+        i++;
+    }
+    cmd->argv[cmd->argc] = NULL;
+    cmd->builtin = find_builtin(cmd->argv[0]);
+    return ((int)(i - first));
 }
 
 /**
- * create_simple_tokenizer - Basic tokenization of input
- * @input: Input string to tokenize
+ * parse_tokens - Split tokens into the commands of a pipeline
+ * @ts: Expanded token stream
+ * @arena: Arena owning the commands
+ * @cmd_count: Receives the number of commands
  *
- * Return: Array of tokens or NULL on failure
+ * A trailing '&' is dropped and marks every command as background.
+ *
+ * Return: Array of cmd_count commands, or NULL on syntax/allocation error
  */
-t_token *create_simple_tokenizer(char *input)
+t_cmd   *parse_tokens(t_tokens *ts, t_arena *arena, int *cmd_count)
 {
-    t_token *tokens;
-    char    **words;
-    int     word_count;
-    int     i;
-    
-    if (!input || ft_strlen(input) == 0)
-        return (NULL);
-    
-    /* For now, use simple space splitting */
-    words = ft_split(input, ' ');
-    if (!words)
-        return (NULL);
-    
-    /* Count words */
-    word_count = 0;
-    while (words[word_count])
-        word_count++;
+    t_cmd   *cmds;
+    int     count;
+    int     background;
+    int     used;
+    int     type;
+    size_t  i;
+    int     c;
     
-    /* Allocate tokens */
-    tokens = malloc((word_count + 1) * sizeof(t_token));
-    if (!tokens)
+    /* Count commands and check that every pipe has a command on each side */
+    count = 1;
+    background = 0;
+    i = 0;
+    while (i < ts->count)
     {
-        /* Free words */
-        i = 0;
-        while (words[i])
-            free(words[i++]);
-        free(words);
-        return (NULL);
+        type = TOKEN_TYPE(ts->kind[i]);
+        if (type == TOK_PIPE || type == TOK_BACKGROUND)
+        {
+            if (i == 0 || TOKEN_TYPE(ts->kind[i - 1]) == TOK_PIPE)
+                return (syntax_error(ts, i));
+            count += (type == TOK_PIPE);
+        }
+        
+        /* '&' may only end the line */
+        if (type == TOK_BACKGROUND && i + 1 < ts->count)
+            return (syntax_error(ts, i + 1));
+        if (type == TOK_BACKGROUND)
+        {
+            ts->count = i;
+            background = 1;
+            break;
+        }
+        i++;
     }
+    if (i > 0 && TOKEN_TYPE(ts->kind[i - 1]) == TOK_PIPE)
+        return (syntax_error(ts, i));
+    
+    cmds = arena_alloc(arena, count * sizeof(t_cmd));
+    if (!cmds)
+        return (NULL);
     
-    /* Fill tokens */
     i = 0;
-    while (i < word_count)
+    c = 0;
+    while (c < count)
     {
-        tokens[i].str = words[i];
-        tokens[i].type = 0;  /* word */
-        tokens[i].quote_type = 0;  /* none */
-        i++;
+        used = parse_command(&cmds[c], ts, i, arena);
+        if (used == -1)
+        {
+            close_heredocs(cmds, c + 1);
+            return (NULL);
+        }
+        cmds[c].background = background;
+        i += used;
+        if (i < ts->count)
+            i++;  /* Skip '|' */
+        c++;
     }
-    tokens[word_count].str = NULL;  /* NULL terminator */
+    *cmd_count = count;
+    return (cmds);
+}
+
+/**
+ * search_path - Search every PATH directory for an executable
+ * @cmd: Command name (without any '/')
+ * @env: Environment store
+ *
+ * Return: Full path to executable or NULL if not found
+ */
+static char *search_path(char *cmd, t_env *env)
+{
+    t_split_iter    it;
+    t_strbuf        *sb;
+    const char      *dir;
+    size_t          dir_len;
+    size_t          cmd_len;
+    struct stat     st;
+    char            *path_env;
     
-    free(words);  /* Only free the array, not the strings */
+    path_env = get_env_value("PATH", env);
+    if (!path_env)
+        return (NULL);
     
-    return (tokens);
+    /* Build each candidate in the scratch buffer; copy only the match */
+    STAT_INC(path_searches);
+    sb = &g_global.scratch;
+    cmd_len = ft_strlen(cmd);
+    split_iter_init(&it, path_env, ":");
+    while ((dir = split_iter_next(&it, &dir_len)) != NULL)
+    {
+        sb->len = 0;
+        if (strbuf_append(sb, dir, dir_len) == -1
+            || strbuf_putc(sb, '/') == -1
+            || strbuf_append(sb, cmd, cmd_len) == -1)
+            return (NULL);
+        STAT_INC(path_stats);
+        if (stat(sb->data, &st) == 0 && (st.st_mode & S_IXUSR))
+            return (ft_strdup(sb->data));
+    }
+    return (NULL);
 }
 
 /**
  * find_executable - Find executable file in PATH or as relative/absolute path
  * @cmd: Command to find
- * @env: Environment variable array
+ * @env: Environment store
+ *
+ * PATH lookups are remembered in the command hash table, including
+ * misses, so repeated commands cost no stat calls. Misses are answered
+ * from the PATH index once it is built; while it is being built, PATH is
+ * searched on every lookup and nothing is remembered.
  *
  * Return: Full path to executable or NULL if not found
  */
-char    *find_executable(char *cmd, char **env)
+char    *find_executable(char *cmd, t_env *env)
 {
-    char    **paths;
     char    *full_path;
-    size_t  i;
+    int     found;
+    int     volatile_dirs;
     struct  stat st;
     
     if (!cmd)
@@ -143,63 +308,68 @@ char    *find_executable(char *cmd, char **env)
     /* Check if it's an absolute or relative path */
     if (cmd[0] == '/' || cmd[0] == '.')
     {
+        STAT_INC(path_stats);
         if (stat(cmd, &st) == 0 && (st.st_mode & S_IXUSR))
             return (ft_strdup(cmd));
         return (NULL);
     }
     
-    /* Search in PATH */
-    char *path_env = get_env_value("PATH", env);
-    if (!path_env)
-        return (NULL);
-    
-    paths = ft_split(path_env, ':');
-    if (!paths)
-        return (NULL);
-    
-    i = 0;
-    while (paths[i])
+    /* Check the command hash table before searching PATH */
+    full_path = hash_lookup(cmd, &found);
+    if (found)
     {
-        full_path = ft_strjoin(paths[i], "/");
-        full_path = ft_strjoin(full_path, cmd);
-        
-        if (stat(full_path, &st) == 0 && (st.st_mode & S_IXUSR))
-        {
-            /* Found executable */
-            size_t j = 0;
-            while (paths[j])
-                free(paths[j++]);
-            free(paths);
-            return (full_path);
-        }
-        
-        free(full_path);
-        i++;
+        STAT_INC(hash_hits);
+        if (!full_path)
+            return (NULL);
+        return (ft_strdup(full_path));
     }
     
-    /* Clean up */
-    i = 0;
-    while (paths[i])
-        free(paths[i++]);
-    free(paths);
-    
-    return (NULL);
+    STAT_INC(hash_misses);
+    if (pathindex_resolve(cmd, &full_path, &volatile_dirs))
+    {
+        /* Unwatched directories may change unseen, so do not remember */
+        if (!volatile_dirs)
+            hash_insert(cmd, full_path);
+        return (full_path);
+    }
+    full_path = search_path(cmd, env);
+    if (!pathindex_warming())
+        hash_insert(cmd, full_path);
+    return (full_path);
+}
+
+/**
+ * exit_status_from_wait - Convert a waitpid status to a shell exit status
+ * @status: Status filled in by waitpid
+ *
+ * Return: Exit code, or 128 + signal number for killed children
+ */
+int     exit_status_from_wait(int status)
+{
+    if (WIFEXITED(status))
+        return (WEXITSTATUS(status));
+    if (WIFSIGNALED(status))
+        return (WTERMSIG(status) + 128);
+    return (1);
 }
 
 /**
  * execute_external_command - Execute external command
  * @cmd: Command to execute
- * @env: Environment variable array
+ * @env: Environment store
  *
  * Return: Exit status
  */
-int     execute_external_command(t_cmd *cmd, char **env)
+int     execute_external_command(t_cmd *cmd, t_env *env)
 {
-    pid_t   pid;
-    char    *executable;
-    int     status;
+    pid_t           pid;
+    char            *executable;
+    int             status;
+    unsigned long   t;
     
+    TRACE_BEGIN(t);
     executable = find_executable(cmd->argv[0], env);
+    TRACE_END("find_executable", t, cmd->argv[0]);
     if (!executable)
     {
         fprintf(stderr, "%s: command not found\n", cmd->argv[0]);
@@ -207,77 +377,52 @@ int     execute_external_command(t_cmd *cmd, char **env)
         return (127);
     }
     
-    pid = fork();
+    TRACE_BEGIN(t);
+    pid = spawn_command(cmd, executable, env_envp(env));
+    TRACE_END("spawn", t, spawn_backend_name(g_global.spawn_backend));
+    free(executable);
     if (pid == -1)
     {
-        fprintf(stderr, "fork: %s\n", strerror(errno));
-        free(executable);
-        g_global.exit_status = 1;
-        return (1);
+        g_global.exit_status = 127;
+        if (cmd->nredirs > 0)
+            g_global.exit_status = 1;
+        return (g_global.exit_status);
     }
     
-    if (pid == 0)
-    {
-        /* Child process */
-        execve(executable, cmd->argv, env);
-        fprintf(stderr, "%s: %s\n", cmd->argv[0], strerror(errno));
-        free(executable);
-        exit(127);
-    }
-    else
-    {
-        /* Parent process */
-        waitpid(pid, &status, 0);
-        free(executable);
-        
-        if (WIFEXITED(status))
-        {
-            g_global.exit_status = WEXITSTATUS(status);
-            return (WEXITSTATUS(status));
-        }
-        else if (WIFSIGNALED(status))
-        {
-            g_global.exit_status = WTERMSIG(status) + 128;
-            return (WTERMSIG(status) + 128);
-        }
-        
-        g_global.exit_status = 1;
-        return (1);
-    }
+    TRACE_BEGIN(t);
+    wait_child(pid, &status, 0);
+    TRACE_END("waitpid", t, cmd->argv[0]);
+    g_global.exit_status = exit_status_from_wait(status);
+    return (g_global.exit_status);
 }
 
 /**
  * execute_command - Execute a single command
  * @cmd: Command to execute
- * @env: Environment variable array
+ * @env: Environment store
  */
-void    execute_command(t_cmd *cmd, char ***env)
+void    execute_command(t_cmd *cmd, t_env *env)
 {
-    if (!cmd || !cmd->argv[0])
+    if (!cmd)
         return;
     
-    /* Check if it's a builtin command */
-    if (is_builtin(cmd->argv[0]))
+    /* Redirections alone still create or truncate, as in sh */
+    if (!cmd->argv[0])
     {
-        /* Execute builtin */
-        if (ft_strcmp(cmd->argv[0], "echo") == 0)
-            ft_echo(cmd->argv, cmd->argc);
-        else if (ft_strcmp(cmd->argv[0], "cd") == 0)
-            ft_cd(cmd->argv, cmd->argc);
-        else if (ft_strcmp(cmd->argv[0], "pwd") == 0)
-            ft_pwd();
-        else if (ft_strcmp(cmd->argv[0], "export") == 0)
-            ft_export(cmd->argv, cmd->argc, env);
-        else if (ft_strcmp(cmd->argv[0], "unset") == 0)
-            ft_unset(cmd->argv, cmd->argc, env);
-        else if (ft_strcmp(cmd->argv[0], "env") == 0)
-            ft_env(*env);
-        else if (ft_strcmp(cmd->argv[0], "exit") == 0)
-            ft_exit(cmd->argv, cmd->argc);
+        if (setup_redirections(cmd) == 0)
+        {
+            cleanup_redirections(cmd);
+            g_global.exit_status = 0;
+        }
+        return;
     }
-    else
+    if (!cmd->builtin)
     {
-        /* Execute external command */
-        execute_external_command(cmd, *env);
+        execute_external_command(cmd, env);
+        return;
     }
-}
\ No newline at end of file
+    if (setup_redirections(cmd) == -1)
+        return;
+    cmd->builtin->fn(cmd, env);
+    cleanup_redirections(cmd);
+}
@@ -0,0 +1,603 @@
+/* pathindex.c - In-memory index of the executables on PATH */
+/* Author: your_login */
+
+#include "minishell.h"
+#include <dirent.h>
+#include <sys/inotify.h>
+
+#define PATHINDEX_MIN_SLOTS 1024
+#define PATHINDEX_EVENTS    (IN_CREATE | IN_DELETE | IN_MOVED_FROM \
+                            | IN_MOVED_TO | IN_ATTRIB | IN_DELETE_SELF \
+                            | IN_MOVE_SELF | IN_ONLYDIR)
+
+/*
+ * At startup a background thread lists every PATH directory and records
+ * each executable name with the rank (position in PATH) of the first
+ * directory holding it, so the first prompt is not delayed. Before
+ * listing a directory the thread puts an inotify watch on it; once the
+ * index is published, the shell drains the watch queue before every
+ * lookup (one non-blocking read) and at the start of every line:
+ *
+ *   a name created, deleted, renamed or chmod'ed in a watched directory
+ *       is re-resolved with stat() and dropped from the command hash
+ *       table (unless pinned with hash -p)
+ *   a watched directory going away, or a queue overflow, starts a new
+ *       build; lookups search PATH with stat() until it is published
+ *
+ * While a build runs, find_executable remembers nothing in the command
+ * hash table, so no answer can outlive a change made during warm-up.
+ *
+ * So find_executable answers from memory, with no stat() at all in the
+ * steady state, yet sees a binary removed or installed by the previous
+ * command. PATH entries that cannot be watched (relative or missing
+ * directories) are still stat()ed on every lookup they could change, and
+ * such answers are not remembered in the hash table.
+ *
+ * Only the process that built the index uses it. Forked children share
+ * the inotify queue with it, so they leave it alone and search PATH as
+ * before; the server does not build an index at all.
+ */
+
+/**
+ * pathindex_find - Find the slot of a name
+ * @pi: Index
+ * @name: Command name
+ * @len: Its length
+ * @hash: hash_string(name, len)
+ *
+ * Return: Slot holding the name, or the empty slot where it would go
+ */
+static size_t   pathindex_find(t_pathindex *pi, const char *name, size_t len,
+                               unsigned int hash)
+{
+    t_pathindex_slot    *slot;
+    size_t              i;
+
+    i = hash & (pi->cap - 1);
+    while (1)
+    {
+        slot = &pi->slots[i];
+        if (slot->name == 0)
+            return (i);
+        if (slot->hash == hash
+            && ft_strncmp(pi->names + slot->name, name, len) == 0
+            && pi->names[slot->name + len] == '\0')
+            return (i);
+        i = (i + 1) & (pi->cap - 1);
+    }
+}
+
+/**
+ * pathindex_grow - Double the slot table, keeping it at most half full
+ * @pi: Index
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+static int  pathindex_grow(t_pathindex *pi)
+{
+    t_pathindex_slot    *old;
+    size_t              old_cap;
+    size_t              i;
+    size_t              j;
+
+    old = pi->slots;
+    old_cap = pi->cap;
+    pi->cap = old_cap ? old_cap * 2 : PATHINDEX_MIN_SLOTS;
+    pi->slots = calloc(pi->cap, sizeof(t_pathindex_slot));
+    if (!pi->slots)
+    {
+        pi->slots = old;
+        pi->cap = old_cap;
+        return (-1);
+    }
+    i = 0;
+    while (i < old_cap)
+    {
+        if (old[i].name)
+        {
+            j = old[i].hash & (pi->cap - 1);
+            while (pi->slots[j].name)
+                j = (j + 1) & (pi->cap - 1);
+            pi->slots[j] = old[i];
+        }
+        i++;
+    }
+    free(old);
+    return (0);
+}
+
+/**
+ * pathindex_name - Copy a name into the name pool
+ * @pi: Index
+ * @name: Name
+ * @len: Its length
+ *
+ * Return: Offset of the copy, or 0 on allocation failure
+ */
+static uint32_t pathindex_name(t_pathindex *pi, const char *name, size_t len)
+{
+    char    *grown;
+    size_t  cap;
+    size_t  off;
+
+    if (pi->names_len + len + 1 > pi->names_cap)
+    {
+        cap = pi->names_cap ? pi->names_cap * 2 : 16384;
+        while (cap < pi->names_len + len + 1)
+            cap *= 2;
+        if (cap > UINT32_MAX)
+            return (0);
+        grown = realloc(pi->names, cap);
+        if (!grown)
+            return (0);
+        pi->names = grown;
+        pi->names_cap = cap;
+    }
+
+    /* Offset 0 marks an empty slot, so the pool starts with a NUL */
+    if (pi->names_len == 0)
+        pi->names[pi->names_len++] = '\0';
+    off = pi->names_len;
+    memcpy(pi->names + off, name, len + 1);
+    pi->names_len += len + 1;
+    return ((uint32_t)off);
+}
+
+/**
+ * pathindex_set - Record the rank of a name
+ * @pi: Index
+ * @name: Command name
+ * @rank: PATH position of the first directory holding it, -1 for none
+ * @first: Only record it if the name is not in the index yet
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+static int  pathindex_set(t_pathindex *pi, const char *name, int rank,
+                          int first)
+{
+    unsigned int    hash;
+    size_t          len;
+    size_t          i;
+
+    len = ft_strlen(name);
+    hash = hash_string(name, len);
+    i = pathindex_find(pi, name, len, hash);
+    if (pi->slots[i].name && first)
+        return (0);
+
+    /* Files that are not executables anywhere on PATH take no room */
+    if (!pi->slots[i].name && rank < 0)
+        return (0);
+    if (!pi->slots[i].name)
+    {
+        if ((pi->used + 1) * 2 > pi->cap)
+        {
+            if (pathindex_grow(pi) == -1)
+                return (-1);
+            i = pathindex_find(pi, name, len, hash);
+        }
+
+        /* Names are never removed; a vanished one keeps rank -1 */
+        pi->slots[i].name = pathindex_name(pi, name, len);
+        if (pi->slots[i].name == 0)
+            return (-1);
+        pi->slots[i].hash = hash;
+        pi->used++;
+    }
+    pi->slots[i].rank = rank;
+    return (0);
+}
+
+/**
+ * pathindex_scan - Add the executables of one directory
+ * @pi: Index
+ * @rank: PATH position of the directory
+ *
+ * Return: 0 on success (an unreadable directory adds nothing), -1 on
+ * allocation failure
+ */
+static int  pathindex_scan(t_pathindex *pi, int rank)
+{
+    DIR             *dir;
+    struct dirent   *de;
+    struct stat     st;
+    int             err;
+
+    dir = opendir(pi->dirs[rank]);
+    if (!dir)
+        return (0);
+    err = 0;
+    while (!err && !__atomic_load_n(&pi->cancel, __ATOMIC_RELAXED)
+        && (de = readdir(dir)) != NULL)
+    {
+        if (de->d_name[0] == '.' && (de->d_name[1] == '\0'
+            || (de->d_name[1] == '.' && de->d_name[2] == '\0')))
+            continue;
+
+        /* Same test as a PATH search: stat() follows links */
+        if (fstatat(dirfd(dir), de->d_name, &st, 0) == 0
+            && (st.st_mode & S_IXUSR))
+            err = pathindex_set(pi, de->d_name, rank, 1);
+    }
+    closedir(dir);
+    return (err);
+}
+
+/**
+ * pathindex_build - Watch and list every PATH directory
+ * @arg: Index to fill; the shell does not touch it until it is published
+ *
+ * Runs beside the shell, so it allocates with plain malloc: the libft and
+ * strbuf wrappers update g_global.stats.
+ *
+ * Return: NULL
+ */
+static void *pathindex_build(void *arg)
+{
+    t_pathindex *pi;
+    int         rank;
+    int         state;
+
+    pi = arg;
+    state = 1;
+    if (pathindex_grow(pi) == -1)
+        state = -1;
+    rank = 0;
+    while (state == 1 && rank < pi->ndirs)
+    {
+        if (__atomic_load_n(&pi->cancel, __ATOMIC_RELAXED))
+            state = -1;
+
+        /* Watch first, so nothing that changes during the listing is lost */
+        else if (pi->dirs[rank][0] == '/')
+            pi->wds[rank] = inotify_add_watch(pi->fd, pi->dirs[rank],
+                PATHINDEX_EVENTS);
+
+        /* Unwatched directories are left to stat() at lookup time */
+        if (state == 1 && pi->wds[rank] >= 0
+            && pathindex_scan(pi, rank) == -1)
+            state = -1;
+        rank++;
+    }
+    __atomic_store_n(&pi->ready, state, __ATOMIC_RELEASE);
+    return (NULL);
+}
+
+/**
+ * pathindex_free - Release the index of this process
+ *
+ * The builder thread must have been joined. The process stays the owner,
+ * so a later change of PATH still starts a new index.
+ */
+static void pathindex_free(void)
+{
+    t_pathindex *pi;
+    pid_t       owner;
+    int         i;
+
+    pi = &g_global.pathindex;
+    owner = pi->owner;
+    if (pi->fd >= 0)
+        close(pi->fd);
+    i = 0;
+    while (i < pi->ndirs)
+        free(pi->dirs[i++]);
+    free(pi->dirs);
+    free(pi->wds);
+    free(pi->slots);
+    free(pi->names);
+    ft_bzero(pi, sizeof(t_pathindex));
+    pi->fd = -1;
+    pi->owner = owner;
+}
+
+/**
+ * pathindex_stop - Stop the builder thread and drop the index
+ *
+ * In a forked child the index belongs to the parent (and the builder
+ * thread may have been copied mid-update), so it is only forgotten.
+ */
+void    pathindex_stop(void)
+{
+    t_pathindex *pi;
+
+    pi = &g_global.pathindex;
+    if (pi->owner != getpid())
+    {
+        if (pi->fd >= 0)
+            close(pi->fd);
+        ft_bzero(pi, sizeof(t_pathindex));
+        pi->fd = -1;
+        return;
+    }
+    if (pi->running)
+    {
+        __atomic_store_n(&pi->cancel, 1, __ATOMIC_RELAXED);
+        pthread_join(pi->thread, NULL);
+    }
+    pathindex_free();
+}
+
+/**
+ * pathindex_start - Build a new index for the current PATH in the background
+ * @env: Environment store
+ *
+ * Without PATH, or if inotify or the thread is unavailable, there is no
+ * index and lookups search PATH as before.
+ */
+void    pathindex_start(t_env *env)
+{
+    t_pathindex     *pi;
+    t_split_iter    it;
+    const char      *dir;
+    size_t          len;
+    char            *path;
+
+    pathindex_stop();
+    pi = &g_global.pathindex;
+    pi->owner = getpid();
+    path = get_env_value("PATH", env);
+    if (!path)
+        return;
+    len = ft_strlen(path) / 2 + 1;
+    pi->dirs = ft_calloc(len, sizeof(char *));
+    pi->wds = malloc(len * sizeof(int));
+    pi->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (!pi->dirs || !pi->wds || pi->fd == -1)
+    {
+        pathindex_free();
+        return;
+    }
+    split_iter_init(&it, path, ":");
+    while ((dir = split_iter_next(&it, &len)) != NULL)
+    {
+        pi->wds[pi->ndirs] = -1;
+        pi->dirs[pi->ndirs] = ft_substr(dir, 0, len);
+        if (!pi->dirs[pi->ndirs++])
+        {
+            pathindex_free();
+            return;
+        }
+    }
+    if (pthread_create(&pi->thread, NULL, pathindex_build, pi) != 0)
+    {
+        pathindex_free();
+        return;
+    }
+    pi->running = 1;
+}
+
+/**
+ * pathindex_refresh - Re-resolve one name after a change in a directory
+ * @pi: Index
+ * @name: Name that was created, removed or changed
+ */
+static void pathindex_refresh(t_pathindex *pi, const char *name)
+{
+    t_strbuf    *sb;
+    struct stat st;
+    int         rank;
+
+    sb = &g_global.scratch;
+    rank = 0;
+    while (rank < pi->ndirs)
+    {
+        sb->len = 0;
+        if (pi->wds[rank] >= 0 && strbuf_append(sb, pi->dirs[rank],
+                ft_strlen(pi->dirs[rank])) == 0 && strbuf_putc(sb, '/') == 0
+            && strbuf_append(sb, name, ft_strlen(name)) == 0
+            && stat(sb->data, &st) == 0 && (st.st_mode & S_IXUSR))
+            break;
+        rank++;
+    }
+    if (rank == pi->ndirs)
+        rank = -1;
+    STAT_INC(index_events);
+    if (pathindex_set(pi, name, rank, 0) == -1)
+        pi->stale = 1;
+    hash_forget(name);
+}
+
+/**
+ * pathindex_drain - Apply every queued directory change
+ * @pi: Published index
+ */
+static void pathindex_drain(t_pathindex *pi)
+{
+    char                    buf[4096]
+        __attribute__((aligned(__alignof__(struct inotify_event))));
+    struct inotify_event    *ev;
+    ssize_t                 n;
+    ssize_t                 i;
+
+    while ((n = read(pi->fd, buf, sizeof(buf))) > 0)
+    {
+        i = 0;
+        while (i < n)
+        {
+            ev = (struct inotify_event *)(buf + i);
+            if (ev->mask & (IN_Q_OVERFLOW | IN_IGNORED | IN_DELETE_SELF
+                    | IN_MOVE_SELF))
+                pi->stale = 1;
+            else if (ev->len > 0)
+                pathindex_refresh(pi, ev->name);
+            i += sizeof(struct inotify_event) + ev->len;
+        }
+    }
+}
+
+/**
+ * pathindex_answer - Resolve a name from a published index
+ * @pi: Index
+ * @name: Command name, without '/'
+ * @path: Receives the full path (malloc'd), or NULL if not found
+ * @volatile_dirs: Set to 1 if an unwatched directory could decide it
+ *
+ * Only unwatched PATH entries before the indexed one are stat()ed.
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+static int  pathindex_answer(t_pathindex *pi, const char *name, char **path,
+                             int *volatile_dirs)
+{
+    t_strbuf    *sb;
+    struct stat st;
+    size_t      len;
+    size_t      i;
+    int         rank;
+    int         r;
+
+    len = ft_strlen(name);
+    i = pathindex_find(pi, name, len, hash_string(name, len));
+    rank = pi->ndirs;
+    if (pi->slots[i].name && pi->slots[i].rank >= 0)
+        rank = pi->slots[i].rank;
+    *volatile_dirs = 0;
+    *path = NULL;
+    sb = &g_global.scratch;
+    r = 0;
+    while (r <= rank && r < pi->ndirs)
+    {
+        if (r == rank || pi->wds[r] < 0)
+        {
+            sb->len = 0;
+            if (strbuf_append(sb, pi->dirs[r], ft_strlen(pi->dirs[r])) == -1
+                || strbuf_putc(sb, '/') == -1
+                || strbuf_append(sb, name, len) == -1)
+                return (-1);
+            if (r == rank)
+                break;
+            *volatile_dirs = 1;
+            STAT_INC(path_stats);
+            if (stat(sb->data, &st) == 0 && (st.st_mode & S_IXUSR))
+                break;
+        }
+        r++;
+    }
+    if (r < pi->ndirs)
+    {
+        *path = ft_strdup(sb->data);
+        if (!*path)
+            return (-1);
+    }
+    return (0);
+}
+
+/**
+ * pathindex_revalidate - Drop remembered commands the index disagrees with
+ * @pi: Index, or NULL if there is none to check against
+ *
+ * Entries pinned with hash -p are kept.
+ */
+static void pathindex_revalidate(t_pathindex *pi)
+{
+    t_cmd_hash  *entry;
+    t_cmd_hash  *next;
+    char        *path;
+    int         volatile_dirs;
+    int         keep;
+    int         i;
+
+    i = 0;
+    while (i < CMD_HASH_SIZE)
+    {
+        entry = g_global.cmd_hash[i];
+        while (entry)
+        {
+            next = entry->next;
+            keep = entry->pinned;
+            if (!keep && pi
+                && pathindex_answer(pi, entry->name, &path,
+                    &volatile_dirs) == 0)
+            {
+                keep = (!volatile_dirs && ((!path && !entry->path)
+                    || (path && entry->path
+                        && ft_strcmp(path, entry->path) == 0)));
+                free(path);
+            }
+            if (!keep)
+                hash_remove(entry->name);
+            entry = next;
+        }
+        i++;
+    }
+}
+
+/**
+ * pathindex_sync - Make the index current, if this process has one
+ *
+ * Collects a freshly built index, then applies queued changes. Called
+ * before every lookup and at the start of every line, so forked children
+ * inherit an up-to-date command hash table.
+ *
+ * Return: 1 if the index can answer lookups, 0 otherwise
+ */
+int     pathindex_sync(void)
+{
+    t_pathindex *pi;
+    int         state;
+
+    pi = &g_global.pathindex;
+    if (pi->owner != getpid() || pi->fd < 0)
+        return (0);
+    state = __atomic_load_n(&pi->ready, __ATOMIC_ACQUIRE);
+    if (state == 0)
+        return (0);
+    if (pi->running)
+    {
+        pthread_join(pi->thread, NULL);
+        pi->running = 0;
+        if (state != 1)
+        {
+            pathindex_free();
+            return (0);
+        }
+
+        /* Lookups made during the build searched PATH themselves */
+        pathindex_drain(pi);
+        if (!pi->stale)
+            pathindex_revalidate(pi);
+    }
+    pathindex_drain(pi);
+    if (pi->stale)
+    {
+        /* Anything remembered may be out of date: rebuild from scratch */
+        pathindex_start(&g_global.env);
+        pathindex_revalidate(NULL);
+        return (0);
+    }
+    return (1);
+}
+
+/**
+ * pathindex_warming - Tell whether this process is still building its index
+ *
+ * Until the index is published, nothing sees PATH directories change, so
+ * PATH searches must not be remembered.
+ *
+ * Return: 1 while the builder thread runs, 0 otherwise
+ */
+int     pathindex_warming(void)
+{
+    return (g_global.pathindex.owner == getpid()
+        && g_global.pathindex.running);
+}
+
+/**
+ * pathindex_resolve - Look a command name up in the index
+ * @name: Command name, without '/'
+ * @path: Receives the full path (malloc'd), or NULL if not found
+ * @volatile_dirs: Set to 1 if an unwatched directory could decide the
+ *                 answer, which must then not be remembered
+ *
+ * Return: 1 if the index answered, 0 if the caller must search PATH
+ */
+int     pathindex_resolve(const char *name, char **path, int *volatile_dirs)
+{
+    if (!pathindex_sync())
+        return (0);
+    STAT_INC(index_lookups);
+    if (pathindex_answer(&g_global.pathindex, name, path, volatile_dirs) == -1)
+        return (0);
+    return (1);
+}
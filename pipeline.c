@@ -0,0 +1,198 @@
+/* pipeline.c - Pipeline execution for Minishell */
+/* Author: your_login */
+
+#define _GNU_SOURCE
+#include "minishell.h"
+
+/**
+ * close_fd - Close a pipe end if it is open
+ * @fd: Descriptor, or -1
+ */
+static void close_fd(int fd)
+{
+    if (fd >= 0)
+        close(fd);
+}
+
+/**
+ * open_stage_pipe - Create the pipe between two stages
+ * @fds: Receives read and write ends
+ *
+ * Both ends are close-on-exec so only the stage that dup2()s an end onto
+ * stdin/stdout keeps it across execve.
+ *
+ * Return: 0 on success, -1 on error
+ */
+static int open_stage_pipe(int fds[2])
+{
+    if (pipe2(fds, O_CLOEXEC) == -1)
+    {
+        fprintf(stderr, "pipe: %s\n", strerror(errno));
+        return (-1);
+    }
+#ifdef F_SETPIPE_SZ
+    if (g_global.pipe_size > 0
+        && fcntl(fds[1], F_SETPIPE_SZ, g_global.pipe_size) == -1)
+        fprintf(stderr, "pipe: cannot set size %d: %s\n",
+            g_global.pipe_size, strerror(errno));
+#endif
+    return (0);
+}
+
+/**
+ * run_builtin_stage - Fork a child running a builtin as one pipeline stage
+ * @cmd: Command for this stage
+ * @next_read: Read end of the following pipe, which this stage must not hold
+ * @env: Environment store
+ *
+ * Return: Child pid, or -1 on error
+ */
+static pid_t run_builtin_stage(t_cmd *cmd, int next_read, t_env *env)
+{
+    pid_t   pid;
+    
+    STAT_INC(forks);
+    pid = fork();
+    if (pid != 0)
+    {
+        if (pid == -1)
+            fprintf(stderr, "fork: %s\n", strerror(errno));
+        return (pid);
+    }
+
+    close_fd(next_read);
+    if (cmd->pipe_in >= 0)
+    {
+        dup2(cmd->pipe_in, STDIN_FILENO);
+        close(cmd->pipe_in);
+    }
+    if (cmd->pipe_out >= 0)
+    {
+        dup2(cmd->pipe_out, STDOUT_FILENO);
+        close(cmd->pipe_out);
+    }
+    execute_command(cmd, env);
+    exit(g_global.exit_status);
+}
+
+/**
+ * start_stage - Start one pipeline stage
+ * @cmd: Command with pipe_in/pipe_out set
+ * @next_read: Read end of the following pipe, or -1
+ * @env: Environment store
+ *
+ * Return: Child pid, or -1 if the stage could not be started
+ */
+static pid_t start_stage(t_cmd *cmd, int next_read, t_env *env)
+{
+    char    *path;
+    pid_t   pid;
+    
+    /* A stage of redirections only runs like a builtin: it just opens them */
+    if (cmd->builtin || !cmd->argv[0])
+        return (run_builtin_stage(cmd, next_read, env));
+    
+    /* Resolve in the parent so the command hash table stays warm */
+    path = find_executable(cmd->argv[0], env);
+    if (!path)
+    {
+        fprintf(stderr, "%s: command not found\n", cmd->argv[0]);
+        return (-1);
+    }
+    pid = spawn_command(cmd, path, env_envp(env));
+    free(path);
+    return (pid);
+}
+
+/**
+ * start_pipeline - Start every stage of a pipeline
+ * @cmd_list: Array of commands, in pipeline order
+ * @cmd_count: Number of commands
+ * @env: Environment store
+ * @pids: Receives one pid per started stage (-1 if it failed)
+ *
+ * The parent closes each pipe end as soon as the stages using it have
+ * been started.
+ *
+ * Return: Number of stages started (cmd_count unless a pipe failed)
+ */
+static int  start_pipeline(t_cmd *cmd_list, int cmd_count, t_env *env,
+                           pid_t *pids)
+{
+    int             fds[2];
+    int             prev_read;
+    int             i;
+    unsigned long   t;
+    
+    /* Nothing buffered may be duplicated into the children */
+    out_flush(&g_global.out);
+    fflush(stdout);
+    
+    prev_read = -1;
+    i = 0;
+    while (i < cmd_count)
+    {
+        fds[0] = -1;
+        fds[1] = -1;
+        if (i < cmd_count - 1 && open_stage_pipe(fds) == -1)
+            break;
+        cmd_list[i].pipe_in = prev_read;
+        cmd_list[i].pipe_out = fds[1];
+        TRACE_BEGIN(t);
+        pids[i] = start_stage(&cmd_list[i], fds[0], env);
+        TRACE_END("stage_start", t, cmd_list[i].argv[0]);
+        
+        close_fd(prev_read);
+        close_fd(fds[1]);
+        prev_read = fds[0];
+        i++;
+    }
+    close_fd(prev_read);
+    return (i);
+}
+
+/**
+ * execute_pipeline - Run commands connected by pipes
+ * @cmd_list: Array of commands, in pipeline order
+ * @cmd_count: Number of commands
+ * @env: Environment store
+ *
+ * Every stage is started before any is waited for, then all children are
+ * reaped. The exit status is that of the last stage. A background
+ * pipeline is recorded as a job instead of being waited for.
+ */
+void    execute_pipeline(t_cmd *cmd_list, int cmd_count, t_env *env)
+{
+    pid_t           *pids;
+    int             status;
+    int             i;
+    int             id;
+    unsigned long   t;
+    
+    pids = arena_alloc(&g_global.arena, cmd_count * sizeof(pid_t));
+    if (!pids)
+        return;
+    i = start_pipeline(cmd_list, cmd_count, env, pids);
+    
+    if (cmd_list[0].background)
+    {
+        id = job_add(pids, i, cmd_list, cmd_count);
+        if (id > 0 && g_global.interactive)
+            fprintf(stderr, "[%d] %d\n", id, (int)g_global.jobs.last_pid);
+        g_global.exit_status = 0;
+        return;
+    }
+    
+    /* Reap every stage that was started; report the last one */
+    g_global.exit_status = 1;
+    if (i == cmd_count && pids[i - 1] == -1)
+        g_global.exit_status = 127;
+    TRACE_BEGIN(t);
+    while (i-- > 0)
+    {
+        if (pids[i] > 0 && wait_child(pids[i], &status, 0) > 0
+            && i == cmd_count - 1)
+            g_global.exit_status = exit_status_from_wait(status);
+    }
+    TRACE_END("pipeline_wait", t, NULL);
+}
@@ -0,0 +1,127 @@
+/* redirect.c - Redirections for Minishell */
+/* Author: your_login */
+
+#include "minishell.h"
+
+/*
+ * Redirections never touch the shell's own stdin/stdout. The shell opens
+ * every file of a command itself, in command line order and close-on-exec,
+ * stopping at the first one that fails (redirect_open); "> a > b" thus
+ * creates both files. Only the last file of each direction is kept:
+ *
+ *   external commands  it becomes stdin/stdout through a dup2 in the
+ *                      child or a posix_spawn file action (spawn.c)
+ *   builtins           g_global.out points at the output file while the
+ *                      builtin runs, so there is no dup/dup2/restore
+ *                      around the call
+ *
+ * A forked builtin pipeline stage runs the builtin path in the child.
+ */
+
+/**
+ * redirect_flags - open(2) flags for one redirection
+ * @type: TOK_REDIR_IN, TOK_REDIR_OUT or TOK_REDIR_APPEND
+ *
+ * Return: Flags, including O_CLOEXEC
+ */
+static int  redirect_flags(int type)
+{
+    if (type == TOK_REDIR_IN)
+        return (O_RDONLY | O_CLOEXEC);
+    if (type == TOK_REDIR_APPEND)
+        return (O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC);
+    return (O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC);
+}
+
+/**
+ * redirect_open - Open a command's redirections in order
+ * @cmd: Command; redir_in/redir_out receive the last file of each direction
+ *
+ * Earlier files of the same direction are closed once the next one is
+ * open. A here-document after an input file hands stdin back to
+ * heredoc_fd, so redir_in is reset to -1.
+ *
+ * Return: 0 on success, -1 on error (reported, nothing left open,
+ *         exit status set to 1)
+ */
+int     redirect_open(t_cmd *cmd)
+{
+    t_redir *r;
+    int     *slot;
+    int     fd;
+    int     i;
+
+    cmd->redir_in = -1;
+    cmd->redir_out = -1;
+    i = 0;
+    while (i < cmd->nredirs)
+    {
+        r = &cmd->redirs[i++];
+        slot = &cmd->redir_out;
+        if (r->type == TOK_REDIR_IN || r->type == TOK_HEREDOC)
+            slot = &cmd->redir_in;
+        fd = -1;
+        if (r->type != TOK_HEREDOC)
+            fd = open(r->file, redirect_flags(r->type), 0666);
+        if (r->type != TOK_HEREDOC && fd == -1)
+        {
+            fprintf(stderr, "minishell: %s: %s\n", r->file, strerror(errno));
+            redirect_close(cmd);
+            g_global.exit_status = 1;
+            return (-1);
+        }
+        if (*slot >= 0)
+            close(*slot);
+        *slot = fd;
+    }
+    return (0);
+}
+
+/**
+ * redirect_close - Close the files opened by redirect_open
+ * @cmd: Command
+ */
+void    redirect_close(t_cmd *cmd)
+{
+    if (cmd->redir_in >= 0)
+        close(cmd->redir_in);
+    if (cmd->redir_out >= 0)
+        close(cmd->redir_out);
+    cmd->redir_in = -1;
+    cmd->redir_out = -1;
+}
+
+/**
+ * setup_redirections - Open a builtin's redirections
+ * @cmd: Command; redir_in/redir_out receive the opened descriptors
+ *
+ * Output is sent to the file by pointing g_global.out at it. The files
+ * are close-on-exec, so nothing the builtin starts inherits them.
+ *
+ * Return: 0 on success, -1 on error (reported, exit status set to 1)
+ */
+int     setup_redirections(t_cmd *cmd)
+{
+    if (redirect_open(cmd) == -1)
+        return (-1);
+    if (cmd->redir_out >= 0)
+    {
+        out_flush(&g_global.out);
+        g_global.out.fd = cmd->redir_out;
+    }
+    return (0);
+}
+
+/**
+ * cleanup_redirections - Close a builtin's redirections
+ * @cmd: Command set up by setup_redirections
+ */
+void    cleanup_redirections(t_cmd *cmd)
+{
+    if (cmd->redir_out >= 0)
+    {
+        out_flush(&g_global.out);
+        g_global.out.fd = STDOUT_FILENO;
+    }
+    redirect_close(cmd);
+}
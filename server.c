@@ -0,0 +1,563 @@
+/* server.c - Persistent command server and thin client */
+/* Author: your_login */
+
+#define _GNU_SOURCE
+#include "minishell.h"
+#include <limits.h>
+#include <poll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/*
+ * minishell --server SOCK starts once, builds its environment store and
+ * envp cache, then accepts connections on a Unix domain socket. Every
+ * connection is served by a forked worker, so clients run concurrently
+ * and each starts from a private copy of the server's warm state: an
+ * 'export' in one session is never seen by another.
+ *
+ * minishell --client SOCK -c 'cmd' is the thin side. It skips
+ * init_globals entirely, connects, and sends one request:
+ *
+ *   uint32_t length, then length bytes of script text
+ *   SCM_RIGHTS: its stdin, stdout, stderr and current directory
+ *
+ * The worker installs those descriptors as its own 0/1/2 and cwd, so the
+ * commands' output goes straight to the client's terminal or pipes with
+ * no copying through the server. When the script finishes (or runs
+ * 'exit') the worker sends back the exit status as a uint32_t and the
+ * client exits with it. If no worker can serve the connection, the server
+ * itself replies SERVER_REFUSED | errno instead, and the client reports
+ * the error.
+ *
+ * The socket is created mode 0600 whatever the umask, and connections
+ * from any other user are refused (SO_PEERCRED): a worker runs commands
+ * with the server's rights.
+ *
+ * Commands a worker resolves through PATH are reported back to the server
+ * over a shared pipe as "name\0path\n" records, so the server's command
+ * hash table, and thus every later worker's, stays warm.
+ */
+
+#define SERVER_FDS          4       /* stdin, stdout, stderr, cwd */
+#define SERVER_BACKLOG      128
+#define SERVER_RECORD_MAX   PIPE_BUF
+#define SERVER_REFUSED      0x80000000u /* status flag; errno in low bits */
+
+/**
+ * server_usage_error - Report a bad --server/--client invocation
+ * @msg: What is wrong
+ *
+ * Return: Always 2
+ */
+static int  server_usage_error(const char *msg)
+{
+    fprintf(stderr, "minishell: %s\n", msg);
+    return (2);
+}
+
+/**
+ * socket_address - Fill a Unix socket address
+ * @addr: Address to fill
+ * @path: Socket path
+ *
+ * Return: 0 on success, -1 if the path is too long
+ */
+static int  socket_address(struct sockaddr_un *addr, const char *path)
+{
+    ft_bzero(addr, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if (ft_strlen(path) >= sizeof(addr->sun_path))
+    {
+        errno = ENAMETOOLONG;
+        return (-1);
+    }
+    ft_strlcpy(addr->sun_path, path, sizeof(addr->sun_path));
+    return (0);
+}
+
+/**
+ * write_full - Write exactly len bytes
+ * @fd: Descriptor
+ * @buf: Source
+ * @len: Bytes to write
+ *
+ * Return: 0 on success, -1 on error
+ */
+static int  write_full(int fd, const void *buf, size_t len)
+{
+    ssize_t n;
+
+    while (len > 0)
+    {
+        n = write(fd, buf, len);
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n == -1)
+            return (-1);
+        buf = (const char *)buf + n;
+        len -= n;
+    }
+    return (0);
+}
+
+/* Worker side */
+
+/**
+ * worker_report_cache - Send the worker's resolved commands to the server
+ *
+ * Skipped if the session changed PATH, since its paths would not be
+ * valid for the server.
+ */
+static void worker_report_cache(void)
+{
+    t_cmd_hash  *entry;
+    char        *path;
+    char        record[SERVER_RECORD_MAX];
+    size_t      name_len;
+    size_t      path_len;
+    int         i;
+
+    path = get_env_value("PATH", &g_global.env);
+    if (!path || !g_global.server.path
+        || ft_strcmp(path, g_global.server.path) != 0)
+        return;
+    i = 0;
+    while (i < CMD_HASH_SIZE)
+    {
+        entry = g_global.cmd_hash[i];
+        while (entry)
+        {
+            name_len = ft_strlen(entry->name);
+            path_len = entry->path ? ft_strlen(entry->path) : 0;
+            if (entry->path && name_len + path_len + 2 <= sizeof(record))
+            {
+                /* One write per record: atomic up to PIPE_BUF */
+                memcpy(record, entry->name, name_len + 1);
+                memcpy(record + name_len + 1, entry->path, path_len);
+                record[name_len + 1 + path_len] = '\n';
+                write(g_global.server.cache_fd[1], record,
+                      name_len + path_len + 2);
+            }
+            entry = entry->next;
+        }
+        i++;
+    }
+}
+
+/**
+ * worker_exit - Send the exit status to the client when the worker exits
+ *
+ * Registered with atexit, so it also runs when the script calls 'exit'.
+ * Forked children of the worker (builtin pipeline stages) skip it.
+ */
+static void worker_exit(void)
+{
+    uint32_t    status;
+
+    if (g_global.server.worker != getpid())
+        return;
+    out_flush(&g_global.out);
+    fflush(stdout);
+    status = (uint32_t)g_global.exit_status & 0xff;
+    write_full(g_global.server.client_fd, &status, sizeof(status));
+    worker_report_cache();
+}
+
+/**
+ * worker_receive - Read a request and install the client's descriptors
+ * @sock: Connected client socket
+ *
+ * Return: Script text (heap), or NULL on a malformed request
+ */
+static char *worker_receive(int sock)
+{
+    char            cbuf[CMSG_SPACE(SERVER_FDS * sizeof(int))];
+    struct msghdr   msg;
+    struct iovec    iov;
+    struct cmsghdr  *cm;
+    uint32_t        len;
+    int             fds[SERVER_FDS];
+    char            *script;
+
+    ft_bzero(&msg, sizeof(msg));
+    iov.iov_base = &len;
+    iov.iov_len = sizeof(len);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cbuf;
+    msg.msg_controllen = sizeof(cbuf);
+    if (recvmsg(sock, &msg, MSG_WAITALL | MSG_CMSG_CLOEXEC) != sizeof(len))
+        return (NULL);
+    cm = CMSG_FIRSTHDR(&msg);
+    if (!cm || cm->cmsg_type != SCM_RIGHTS
+        || cm->cmsg_len != CMSG_LEN(SERVER_FDS * sizeof(int)))
+        return (NULL);
+    memcpy(fds, CMSG_DATA(cm), sizeof(fds));
+
+    /* The client's stdio becomes ours; its cwd becomes ours */
+    if (dup2(fds[0], STDIN_FILENO) == -1 || dup2(fds[1], STDOUT_FILENO) == -1
+        || dup2(fds[2], STDERR_FILENO) == -1 || fchdir(fds[3]) == -1)
+        return (NULL);
+    close(fds[0]);
+    close(fds[1]);
+    close(fds[2]);
+    close(fds[3]);
+
+    script = malloc((size_t)len + 1);
+    if (!script || read_full(sock, script, len) == -1)
+    {
+        free(script);
+        return (NULL);
+    }
+    script[len] = '\0';
+    return (script);
+}
+
+/**
+ * worker_run - Serve one connection; never returns
+ * @sock: Connected client socket
+ */
+static void worker_run(int sock)
+{
+    char    *script;
+    char    *line;
+
+    close(g_global.server.listen_fd);
+    close(g_global.server.cache_fd[0]);
+    g_global.server.client_fd = sock;
+    g_global.server.worker = getpid();
+    script = worker_receive(sock);
+    if (!script)
+        _exit(2);
+    atexit(worker_exit);
+    g_global.interactive = 0;
+    if (input_open_string(&g_global.input, script) == -1)
+        exit(1);
+    free(script);
+    while ((line = read_input()) != NULL)
+        process_command(line, &g_global.env);
+    exit(g_global.exit_status);
+}
+
+/* Server side */
+
+/**
+ * server_merge_cache - Add resolved commands reported by workers
+ * @buf: Buffer of pending record bytes
+ * @len: In: bytes already in buf. Out: bytes of an incomplete record kept
+ */
+static void server_merge_cache(char *buf, size_t *len)
+{
+    char    *rec;
+    char    *nl;
+    char    *path;
+    size_t  used;
+    int     found;
+
+    rec = buf;
+    while ((nl = ft_memchr(rec, '\n', buf + *len - rec)) != NULL)
+    {
+        *nl = '\0';
+        path = rec + ft_strlen(rec) + 1;
+        if (path < nl)
+        {
+            hash_lookup(rec, &found);
+            if (!found)
+                hash_insert(rec, path);
+        }
+        rec = nl + 1;
+    }
+    used = rec - buf;
+    memmove(buf, rec, *len - used);
+    *len -= used;
+}
+
+/**
+ * server_reap - Collect exited workers
+ */
+static void server_reap(void)
+{
+    struct signalfd_siginfo info[8];
+
+    if (g_global.jobs.sigfd >= 0)
+    {
+        while (read(g_global.jobs.sigfd, info, sizeof(info)) > 0)
+            ;
+    }
+    while (waitpid(-1, NULL, WNOHANG) > 0)
+        ;
+}
+
+/**
+ * server_refuse - Tell a client that no worker will serve it
+ * @sock: Accepted connection, closed by the caller
+ * @err: errno value to report
+ */
+static void server_refuse(int sock, int err)
+{
+    uint32_t    status;
+
+    status = SERVER_REFUSED | (uint32_t)err;
+    write_full(sock, &status, sizeof(status));
+}
+
+/**
+ * server_peer_allowed - Check that a client runs as our own user
+ * @sock: Accepted connection
+ *
+ * Return: 1 if the peer's uid is ours, 0 otherwise (reported)
+ */
+static int  server_peer_allowed(int sock)
+{
+    struct ucred    cred;
+    socklen_t       len;
+
+    len = sizeof(cred);
+    if (getsockopt(sock, SOL_SOCKET, SO_PEERCRED, &cred, &len) == -1)
+    {
+        fprintf(stderr, "minishell: SO_PEERCRED: %s\n", strerror(errno));
+        return (0);
+    }
+    if (cred.uid != geteuid())
+    {
+        fprintf(stderr, "minishell: connection from uid %u refused\n",
+            (unsigned int)cred.uid);
+        return (0);
+    }
+    return (1);
+}
+
+/**
+ * server_listen - Create the listening socket
+ * @path: Socket path; a stale socket is replaced, any other file is kept
+ *
+ * Return: Listening descriptor, or -1 on error (reported)
+ */
+static int  server_listen(const char *path)
+{
+    struct sockaddr_un  addr;
+    struct stat         st;
+    mode_t              mask;
+    int                 fd;
+    int                 ret;
+
+    if (socket_address(&addr, path) == -1)
+    {
+        fprintf(stderr, "minishell: %s: %s\n", path, strerror(errno));
+        return (-1);
+    }
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1)
+    {
+        fprintf(stderr, "minishell: socket: %s\n", strerror(errno));
+        return (-1);
+    }
+
+    /* Only a stale socket is replaced, never some other file */
+    if (lstat(path, &st) == 0)
+    {
+        if (!S_ISSOCK(st.st_mode))
+            errno = EEXIST;
+        if (!S_ISSOCK(st.st_mode) || unlink(path) == -1)
+        {
+            fprintf(stderr, "minishell: %s: %s\n", path, strerror(errno));
+            close(fd);
+            return (-1);
+        }
+    }
+
+    /* Owner only, whatever the caller's umask */
+    mask = umask(0177);
+    ret = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+    umask(mask);
+    if (ret == -1 || listen(fd, SERVER_BACKLOG) == -1)
+    {
+        fprintf(stderr, "minishell: %s: %s\n", path, strerror(errno));
+        close(fd);
+        return (-1);
+    }
+    return (fd);
+}
+
+/**
+ * server_run - Serve command requests until killed
+ * @path: Socket path
+ *
+ * Return: Exit status on a startup error (the loop never returns)
+ */
+int     server_run(const char *path)
+{
+    struct pollfd   fds[3];
+    char            pending[SERVER_RECORD_MAX * 2];
+    size_t          pending_len;
+    ssize_t         n;
+    pid_t           pid;
+    int             sock;
+    char            *env_path;
+
+    g_global.server.listen_fd = server_listen(path);
+    if (g_global.server.listen_fd == -1)
+        return (1);
+    if (pipe2(g_global.server.cache_fd, O_CLOEXEC) == -1)
+        return (1);
+    fcntl(g_global.server.cache_fd[0], F_SETFL, O_NONBLOCK);
+
+    /* Warm what every worker would otherwise build on its own */
+    env_path = get_env_value("PATH", &g_global.env);
+    if (env_path)
+        g_global.server.path = ft_strdup(env_path);
+    env_envp(&g_global.env);
+
+    fds[0].fd = g_global.server.listen_fd;
+    fds[1].fd = g_global.server.cache_fd[0];
+    fds[2].fd = g_global.jobs.sigfd;
+    fds[0].events = POLLIN;
+    fds[1].events = POLLIN;
+    fds[2].events = POLLIN;
+    fds[2].revents = 0;
+    pending_len = 0;
+    while (1)
+    {
+        /* Without a signalfd, workers are reaped on every wakeup */
+        if (poll(fds, 2 + (fds[2].fd >= 0), -1) == -1)
+            continue;
+        if (fds[2].fd < 0 || (fds[2].revents & POLLIN))
+            server_reap();
+        if (fds[1].revents & POLLIN)
+        {
+            n = read(fds[1].fd, pending + pending_len,
+                     sizeof(pending) - pending_len);
+            if (n > 0)
+                pending_len += n;
+            server_merge_cache(pending, &pending_len);
+            if (pending_len == sizeof(pending))
+                pending_len = 0;
+        }
+        if (fds[0].revents & POLLIN)
+        {
+            sock = accept4(g_global.server.listen_fd, NULL, NULL,
+                           SOCK_CLOEXEC);
+            if (sock == -1)
+                continue;
+            if (!server_peer_allowed(sock))
+            {
+                server_refuse(sock, EACCES);
+                close(sock);
+                continue;
+            }
+            out_flush(&g_global.out);
+            fflush(stdout);
+            pid = fork();
+            if (pid == 0)
+                worker_run(sock);
+            if (pid == -1)
+            {
+                fprintf(stderr, "minishell: fork: %s\n", strerror(errno));
+                server_refuse(sock, errno);
+            }
+            close(sock);
+        }
+    }
+    return (0);
+}
+
+/* Client side */
+
+/**
+ * client_send - Send the request and our descriptors
+ * @sock: Connected socket
+ * @script: Script text
+ *
+ * Return: 0 on success, -1 on error
+ */
+static int  client_send(int sock, const char *script)
+{
+    char            cbuf[CMSG_SPACE(SERVER_FDS * sizeof(int))];
+    struct msghdr   msg;
+    struct iovec    iov;
+    struct cmsghdr  *cm;
+    uint32_t        len;
+    int             fds[SERVER_FDS];
+
+    fds[0] = STDIN_FILENO;
+    fds[1] = STDOUT_FILENO;
+    fds[2] = STDERR_FILENO;
+    fds[3] = open(".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fds[3] == -1)
+        return (-1);
+    len = (uint32_t)ft_strlen(script);
+    iov.iov_base = &len;
+    iov.iov_len = sizeof(len);
+    ft_bzero(&msg, sizeof(msg));
+    ft_bzero(cbuf, sizeof(cbuf));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cbuf;
+    msg.msg_controllen = sizeof(cbuf);
+    cm = CMSG_FIRSTHDR(&msg);
+    cm->cmsg_level = SOL_SOCKET;
+    cm->cmsg_type = SCM_RIGHTS;
+    cm->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cm), fds, sizeof(fds));
+    if (sendmsg(sock, &msg, 0) != sizeof(len))
+    {
+        close(fds[3]);
+        return (-1);
+    }
+    close(fds[3]);
+    return (write_full(sock, script, len));
+}
+
+/**
+ * client_run - Run a command line on a server and relay its exit status
+ * @argc: Argument count
+ * @argv: minishell --client SOCK -c CMD
+ *
+ * Called before init_globals: the client builds no shell state at all.
+ *
+ * Return: Exit status of the command line, or 2 on usage/connection error
+ */
+int     client_run(int argc, char **argv)
+{
+    struct sockaddr_un  addr;
+    uint32_t            status;
+    int                 sock;
+    int                 err;
+
+    if (argc != 5 || ft_strcmp(argv[3], "-c") != 0)
+        return (server_usage_error("usage: minishell --client SOCK -c CMD"));
+    if (socket_address(&addr, argv[2]) == -1)
+        return (server_usage_error(strerror(errno)));
+    sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock == -1 || connect(sock, (struct sockaddr *)&addr,
+            sizeof(addr)) == -1)
+    {
+        fprintf(stderr, "minishell: %s: %s\n", argv[2], strerror(errno));
+        return (2);
+    }
+
+    /* A refusing server may close first: its reply is still readable */
+    signal(SIGPIPE, SIG_IGN);
+    err = 0;
+    if (client_send(sock, argv[4]) == -1)
+        err = errno;
+
+    /* The server writes to our stdout/stderr directly; wait for status */
+    if (read_full(sock, &status, sizeof(status)) == -1)
+    {
+        if (err)
+            fprintf(stderr, "minishell: %s: %s\n", argv[2], strerror(err));
+        else
+            fprintf(stderr, "minishell: %s: connection lost\n", argv[2]);
+        return (2);
+    }
+    close(sock);
+    if (status & SERVER_REFUSED)
+    {
+        fprintf(stderr, "minishell: %s: server: %s\n", argv[2],
+            strerror((int)(status & ~SERVER_REFUSED)));
+        return (2);
+    }
+    return ((int)status);
+}
@@ -0,0 +1,276 @@
+/* spawn.c - Process launch backends for Minishell */
+/* Author: your_login */
+
+#define _GNU_SOURCE
+#include "minishell.h"
+#include <spawn.h>
+
+/*
+ * External commands are started through one of four backends, chosen
+ * at runtime with --spawn=NAME or the MINISHELL_SPAWN variable:
+ *
+ *   posix_spawn  posix_spawn(3) with file actions (default; glibc uses
+ *                clone(CLONE_VM|CLONE_VFORK), so no page tables are copied)
+ *   vfork        vfork(2); the child shares the shell's memory until
+ *                execve, so it makes only system calls plus strerror
+ *                (see spawn_child_exec) and never allocates or uses stdio
+ *   helper       a small launcher process forks on the shell's behalf
+ *                (spawn_helper.c), so the fork copies its pages, not ours
+ *   fork         plain fork(2), kept as the fallback
+ */
+
+static const char   *g_backend_names[] = {"fork", "posix_spawn", "vfork",
+    "helper"};
+
+/**
+ * spawn_backend_from_name - Parse a backend name
+ * @name: "fork", "posix_spawn", "vfork" or "helper"
+ *
+ * Return: SPAWN_* constant, or -1 if the name is unknown
+ */
+int     spawn_backend_from_name(const char *name)
+{
+    int     i;
+    
+    i = 0;
+    while (i < SPAWN_BACKEND_COUNT)
+    {
+        if (ft_strcmp(name, g_backend_names[i]) == 0)
+            return (i);
+        i++;
+    }
+    return (-1);
+}
+
+/**
+ * spawn_backend_name - Get the name of a backend
+ * @backend: SPAWN_* constant
+ *
+ * Return: Backend name
+ */
+const char  *spawn_backend_name(int backend)
+{
+    if (backend < 0 || backend >= SPAWN_BACKEND_COUNT)
+        return ("unknown");
+    return (g_backend_names[backend]);
+}
+
+/**
+ * child_error - Report a failed execve from a forked or vforked child
+ * @name: Command name
+ * @err: errno value
+ *
+ * Uses strerror and write(2) only, so it is safe in a vfork child:
+ * execve fails with a known errno, whose message is a static string.
+ */
+static void child_error(const char *name, int err)
+{
+    const char  *msg;
+    
+    msg = strerror(err);
+    write(STDERR_FILENO, name, ft_strlen(name));
+    write(STDERR_FILENO, ": ", 2);
+    write(STDERR_FILENO, msg, ft_strlen(msg));
+    write(STDERR_FILENO, "\n", 1);
+}
+
+/**
+ * spawn_child_exec - Set up stdin/stdout and exec; never returns
+ * @cmd: Command with pipe_in/pipe_out and redirections set
+ * @path: Resolved executable
+ * @envp: Environment for the new program
+ *
+ * Redirections (opened by spawn_command) are applied after the pipes,
+ * so they take precedence. Also used by the spawn helper's children.
+ *
+ * In a vfork child every call here must leave the shell's memory alone:
+ *   sigprocmask, signal  change the child's own mask and dispositions,
+ *                        which are kernel state vfork does not share
+ *   dup2, execve, _exit  plain system calls on the child's fd table
+ *   child_error          strerror and write(2), on execve failure only
+ * Files are never opened here; spawn_command opens them in the parent.
+ */
+void    spawn_child_exec(t_cmd *cmd, const char *path, char **envp)
+{
+    sigset_t    none;
+    
+    /* Undo the shell's blocked SIGCHLD and ignored SIGINT/SIGQUIT */
+    sigemptyset(&none);
+    sigprocmask(SIG_SETMASK, &none, NULL);
+    if (!cmd->background)
+    {
+        signal(SIGINT, SIG_DFL);
+        signal(SIGQUIT, SIG_DFL);
+    }
+    if (cmd->pipe_in >= 0 && dup2(cmd->pipe_in, STDIN_FILENO) == -1)
+        _exit(1);
+    if (cmd->pipe_out >= 0 && dup2(cmd->pipe_out, STDOUT_FILENO) == -1)
+        _exit(1);
+    if (cmd->pipe_err >= 0 && dup2(cmd->pipe_err, STDERR_FILENO) == -1)
+        _exit(1);
+    if (cmd->heredoc_fd >= 0 && dup2(cmd->heredoc_fd, STDIN_FILENO) == -1)
+        _exit(1);
+    if (cmd->redir_in >= 0 && dup2(cmd->redir_in, STDIN_FILENO) == -1)
+        _exit(1);
+    if (cmd->redir_out >= 0 && dup2(cmd->redir_out, STDOUT_FILENO) == -1)
+        _exit(1);
+    execve(path, cmd->argv, envp);
+    child_error(cmd->argv[0], errno);
+    _exit(127);
+}
+
+/**
+ * spawn_signals - Give a posix_spawn child a clean signal state
+ * @cmd: Command being started
+ * @attr: Attributes to fill
+ *
+ * The shell blocks SIGCHLD and ignores SIGINT/SIGQUIT; the child gets an
+ * empty mask and, unless it runs in the background, default handling of
+ * SIGINT/SIGQUIT so it can be interrupted.
+ *
+ * Return: 0 on success, an error number on failure
+ */
+static int  spawn_signals(t_cmd *cmd, posix_spawnattr_t *attr)
+{
+    sigset_t    none;
+    sigset_t    dfl;
+    int         err;
+    
+    sigemptyset(&none);
+    sigemptyset(&dfl);
+    if (!cmd->background)
+    {
+        sigaddset(&dfl, SIGINT);
+        sigaddset(&dfl, SIGQUIT);
+    }
+    err = posix_spawnattr_setsigmask(attr, &none);
+    if (!err)
+        err = posix_spawnattr_setsigdefault(attr, &dfl);
+    if (!err)
+        err = posix_spawnattr_setflags(attr,
+                POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+    return (err);
+}
+
+/**
+ * spawn_posix - Launch with posix_spawn, expressing fd setup as file actions
+ * @cmd: Command with pipe_in/pipe_out and redirections set
+ * @path: Resolved executable
+ * @envp: Environment for the new program
+ *
+ * Return: Child pid, or -1 on error (already reported)
+ */
+static pid_t spawn_posix(t_cmd *cmd, const char *path, char **envp)
+{
+    posix_spawn_file_actions_t  actions;
+    posix_spawnattr_t           attr;
+    pid_t                       pid;
+    int                         err;
+    
+    if (posix_spawn_file_actions_init(&actions) != 0)
+        return (-1);
+    if (posix_spawnattr_init(&attr) != 0)
+    {
+        posix_spawn_file_actions_destroy(&actions);
+        return (-1);
+    }
+    err = spawn_signals(cmd, &attr);
+    if (!err && cmd->pipe_in >= 0)
+        err = posix_spawn_file_actions_adddup2(&actions, cmd->pipe_in,
+                                               STDIN_FILENO);
+    if (!err && cmd->pipe_out >= 0)
+        err = posix_spawn_file_actions_adddup2(&actions, cmd->pipe_out,
+                                               STDOUT_FILENO);
+    if (!err && cmd->pipe_err >= 0)
+        err = posix_spawn_file_actions_adddup2(&actions, cmd->pipe_err,
+                                               STDERR_FILENO);
+    
+    /* Redirections come last, so they replace the pipes */
+    if (!err && cmd->heredoc_fd >= 0)
+        err = posix_spawn_file_actions_adddup2(&actions, cmd->heredoc_fd,
+                                               STDIN_FILENO);
+    if (!err && cmd->redir_in >= 0)
+        err = posix_spawn_file_actions_adddup2(&actions, cmd->redir_in,
+                                               STDIN_FILENO);
+    if (!err && cmd->redir_out >= 0)
+        err = posix_spawn_file_actions_adddup2(&actions, cmd->redir_out,
+                                               STDOUT_FILENO);
+    if (!err)
+        err = posix_spawn(&pid, path, &actions, &attr, cmd->argv, envp);
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+    if (err)
+        fprintf(stderr, "%s: %s\n", cmd->argv[0], strerror(err));
+    if (err)
+        return (-1);
+    return (pid);
+}
+
+/**
+ * spawn_start - Start an external command with the selected backend
+ * @cmd: Command, as for spawn_command, with its redirections open
+ * @path: Resolved executable
+ * @envp: Environment for the new program
+ *
+ * Return: Child pid, or -1 on error (already reported)
+ */
+static pid_t    spawn_start(t_cmd *cmd, const char *path, char **envp)
+{
+    pid_t   pid;
+    
+    if (g_global.spawn_backend == SPAWN_POSIX)
+    {
+        STAT_INC(spawns);
+        return (spawn_posix(cmd, path, envp));
+    }
+    
+    /* The helper is optional: if it cannot run, posix_spawn takes over */
+    if (g_global.spawn_backend == SPAWN_HELPER)
+    {
+        STAT_INC(spawns);
+        pid = helper_spawn(cmd, path, envp);
+        if (pid != 0)
+            return (pid);
+        return (spawn_posix(cmd, path, envp));
+    }
+    
+    STAT_INC(forks);
+    if (g_global.spawn_backend == SPAWN_VFORK)
+        pid = vfork();
+    else
+        pid = fork();
+    if (pid == 0)
+        spawn_child_exec(cmd, path, envp);
+    if (pid == -1)
+        fprintf(stderr, "%s: %s\n", spawn_backend_name(g_global.spawn_backend),
+            strerror(errno));
+    return (pid);
+}
+
+/**
+ * spawn_command - Start an external command
+ * @cmd: Command; pipe_in/pipe_out/pipe_err (-1 for none) become
+ *       stdin/stdout/stderr, then its redirections replace them
+ * @path: Resolved executable
+ * @envp: Environment for the new program
+ *
+ * The redirections are opened here, in order, before any backend runs,
+ * and closed again once the child holds its copies.
+ * Any other descriptor the child should not inherit must be close-on-exec.
+ *
+ * Return: Child pid, or -1 on error (already reported)
+ */
+pid_t   spawn_command(t_cmd *cmd, const char *path, char **envp)
+{
+    pid_t   pid;
+    
+    /* Nothing buffered may be duplicated into the child */
+    out_flush(&g_global.out);
+    fflush(stdout);
+    
+    if (redirect_open(cmd) == -1)
+        return (-1);
+    pid = spawn_start(cmd, path, envp);
+    redirect_close(cmd);
+    return (pid);
+}
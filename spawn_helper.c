@@ -0,0 +1,497 @@
+/* spawn_helper.c - Launcher process for the helper spawn backend */
+/* Author: your_login */
+
+#define _GNU_SOURCE
+#include "minishell.h"
+#include <spawn.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+
+/*
+ * fork() costs time proportional to the parent's mapped memory, so a
+ * shell that has grown a large heap pays for it on every command. With
+ * --spawn=helper the shell instead starts, on first use, a copy of
+ * itself that stops before init_globals (minishell --spawn-helper) and
+ * so stays a few hundred KB. Every external command is then a request
+ * to the helper over a Unix socket pair:
+ *
+ *   t_helper_req header, plus SCM_RIGHTS: the command's stdin, stdout
+ *   and stderr (a redirection the shell opened, a pipe or the shell's
+ *   own), the shell's current directory and, if any, the here-document
+ *   args_len bytes: path\0 argv[0]\0 ...
+ *   env_len bytes: the environment, omitted when the helper already
+ *   holds the same envp generation
+ *
+ * The helper forks with clone(CLONE_PARENT), so the command is the
+ * shell's child, not the helper's: wait_child, job control and the
+ * rusage accounting work as with any other backend. The child runs
+ * spawn_child_exec and the helper replies with the pid, or -errno.
+ *
+ * If the helper cannot be started or goes away, commands fall back to
+ * posix_spawn. Forked children of the shell (pipeline builtins,
+ * substitutions, server workers) start a helper of their own, since
+ * their stdio and cwd may differ from the one the helper was given.
+ */
+
+#define HELPER_FDS      5   /* stdin, stdout, stderr, cwd, heredoc */
+#define HELPER_ENV_SAME 0xffffffffu
+
+typedef struct s_helper_req {
+    uint32_t    args_len;   // bytes of path and argv
+    uint32_t    env_len;    // bytes of environment strings
+    uint32_t    argc;
+    uint32_t    envc;       // HELPER_ENV_SAME: reuse the last environment
+    uint8_t     heredoc;    // a fifth descriptor is attached
+    uint8_t     background;
+}   t_helper_req;
+
+/* Helper side: buffers reused from one request to the next */
+typedef struct s_helper_state {
+    t_strbuf    args;
+    t_strbuf    env;
+    char        **argv;
+    size_t      argv_cap;
+    char        **envp;
+    size_t      envp_cap;
+}   t_helper_state;
+
+/**
+ * send_full - Send exactly len bytes on a socket
+ * @fd: Socket
+ * @buf: Source
+ * @len: Bytes to send
+ *
+ * MSG_NOSIGNAL turns a dead peer into EPIPE instead of SIGPIPE.
+ *
+ * Return: 0 on success, -1 on error
+ */
+static int  send_full(int fd, const void *buf, size_t len)
+{
+    ssize_t n;
+
+    while (len > 0)
+    {
+        n = send(fd, buf, len, MSG_NOSIGNAL);
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n == -1)
+            return (-1);
+        buf = (const char *)buf + n;
+        len -= n;
+    }
+    return (0);
+}
+
+/* Helper side */
+
+/**
+ * helper_receive - Read one request header and its descriptors
+ * @fd: Socket to the shell
+ * @req: Receives the header
+ * @fds: Receives stdin, stdout, stderr, cwd and maybe the heredoc
+ *
+ * Return: Number of descriptors received, or -1 at end of stream or on
+ *         a malformed request
+ */
+static int  helper_receive(int fd, t_helper_req *req, int *fds)
+{
+    struct msghdr   msg;
+    struct iovec    iov;
+    char            cbuf[CMSG_SPACE(HELPER_FDS * sizeof(int))];
+    struct cmsghdr  *cm;
+    int             nfds;
+
+    ft_bzero(&msg, sizeof(msg));
+    iov.iov_base = req;
+    iov.iov_len = sizeof(*req);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cbuf;
+    msg.msg_controllen = sizeof(cbuf);
+    if (recvmsg(fd, &msg, MSG_WAITALL | MSG_CMSG_CLOEXEC) != sizeof(*req))
+        return (-1);
+    nfds = HELPER_FDS - 1 + (req->heredoc != 0);
+    cm = CMSG_FIRSTHDR(&msg);
+    if (!cm || cm->cmsg_type != SCM_RIGHTS
+        || cm->cmsg_len != CMSG_LEN(nfds * sizeof(int)))
+        return (-1);
+    memcpy(fds, CMSG_DATA(cm), nfds * sizeof(int));
+    return (nfds);
+}
+
+/**
+ * helper_read - Read a request's strings into a reusable buffer
+ * @fd: Socket to the shell
+ * @sb: Buffer; its previous contents are discarded
+ * @len: Bytes to read
+ *
+ * Return: 0 on success, -1 on error
+ */
+static int  helper_read(int fd, t_strbuf *sb, size_t len)
+{
+    sb->len = 0;
+    if (strbuf_reserve(sb, len) == -1 || read_full(fd, sb->data, len) == -1)
+        return (-1);
+    sb->len = len;
+    return (0);
+}
+
+/**
+ * helper_split - Point a vector at consecutive NUL-terminated strings
+ * @sb: Buffer holding the strings
+ * @off: Offset of the first string; advanced past the last one
+ * @count: Number of strings
+ * @vec: Vector, grown as needed and NULL-terminated
+ * @cap: Capacity of vec
+ *
+ * Return: 0 on success, -1 if the buffer is short or allocation fails
+ */
+static int  helper_split(t_strbuf *sb, size_t *off, uint32_t count,
+                         char ***vec, size_t *cap)
+{
+    char        **grown;
+    uint32_t    i;
+
+    if (count + 1 > *cap)
+    {
+        grown = realloc(*vec, (count + 1) * sizeof(char *));
+        if (!grown)
+            return (-1);
+        *vec = grown;
+        *cap = count + 1;
+    }
+    i = 0;
+    while (i < count)
+    {
+        if (*off >= sb->len)
+            return (-1);
+        (*vec)[i++] = sb->data + *off;
+        *off += ft_strlen(sb->data + *off) + 1;
+    }
+    (*vec)[count] = NULL;
+    return (0);
+}
+
+/**
+ * helper_launch - Start one command as a child of the shell
+ * @st: Helper buffers holding the request's strings
+ * @req: Request header
+ * @fds: Descriptors received with the request
+ *
+ * Return: Child pid, or -errno
+ */
+static int32_t  helper_launch(t_helper_state *st, t_helper_req *req, int *fds)
+{
+    t_cmd   cmd;
+    size_t  off;
+    char    *path;
+    pid_t   pid;
+
+    path = st->args.data;
+    off = ft_strlen(path) + 1;
+    if (helper_split(&st->args, &off, req->argc, &st->argv,
+            &st->argv_cap) == -1 || req->argc == 0)
+        return (-EPROTO);
+    ft_bzero(&cmd, sizeof(cmd));
+    cmd.argv = st->argv;
+    cmd.argc = req->argc;
+    st->argv[req->argc] = NULL;
+    cmd.background = req->background;
+    cmd.pipe_in = fds[0];
+    cmd.pipe_out = fds[1];
+    cmd.pipe_err = fds[2];
+    cmd.redir_in = -1;
+    cmd.redir_out = -1;
+    cmd.heredoc_fd = -1;
+    if (req->heredoc)
+        cmd.heredoc_fd = fds[4];
+
+    /* The child inherits the cwd; the helper just follows the shell */
+    if (fchdir(fds[3]) == -1)
+        return (-errno);
+    pid = syscall(SYS_clone, CLONE_PARENT | SIGCHLD, 0, NULL, NULL, 0);
+    if (pid == 0)
+        spawn_child_exec(&cmd, path, st->envp);
+    if (pid == -1)
+        return (-errno);
+    return (pid);
+}
+
+/**
+ * helper_main - Serve launch requests until the shell goes away
+ * @fd: Socket to the shell
+ *
+ * Runs instead of the shell for 'minishell --spawn-helper', before
+ * init_globals, so the process stays small.
+ *
+ * Return: Exit status (0 when the shell closed the socket)
+ */
+int     helper_main(int fd)
+{
+    t_helper_state  st;
+    t_helper_req    req;
+    size_t          off;
+    int             fds[HELPER_FDS];
+    int             nfds;
+    int32_t         reply;
+
+    /* posix_spawn's dup2 cleared close-on-exec; commands must not see it */
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    ft_bzero(&st, sizeof(st));
+    while (1)
+    {
+        nfds = helper_receive(fd, &req, fds);
+        if (nfds == -1 || helper_read(fd, &st.args, req.args_len) == -1
+            || (req.envc != HELPER_ENV_SAME
+                && helper_read(fd, &st.env, req.env_len) == -1))
+            break;
+        off = 0;
+        reply = -EPROTO;
+        if (req.args_len > 0 && st.args.data[req.args_len - 1] == '\0'
+            && (req.envc != HELPER_ENV_SAME || st.envp)
+            && (req.envc == HELPER_ENV_SAME || helper_split(&st.env, &off,
+                    req.envc, &st.envp, &st.envp_cap) == 0))
+            reply = helper_launch(&st, &req, fds);
+        while (nfds > 0)
+            close(fds[--nfds]);
+        if (send_full(fd, &reply, sizeof(reply)) == -1)
+            break;
+    }
+    strbuf_free(&st.args);
+    strbuf_free(&st.env);
+    free(st.argv);
+    free(st.envp);
+    return (0);
+}
+
+/* Shell side */
+
+/**
+ * helper_start - Start the helper process
+ *
+ * Return: 0 on success, -1 on error
+ */
+static int  helper_start(void)
+{
+    posix_spawn_file_actions_t  actions;
+    char                        *argv[3];
+    char                        *envp[1];
+    int                         sv[2];
+    int                         err;
+
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) == -1)
+        return (-1);
+
+    /* dup2 onto itself would keep close-on-exec set */
+    if (sv[1] == SPAWN_HELPER_FD)
+    {
+        sv[1] = fcntl(SPAWN_HELPER_FD, F_DUPFD_CLOEXEC, SPAWN_HELPER_FD + 1);
+        close(SPAWN_HELPER_FD);
+    }
+    argv[0] = "minishell";
+    argv[1] = "--spawn-helper";
+    argv[2] = NULL;
+    envp[0] = NULL;
+    err = EINVAL;
+    if (sv[1] != -1 && posix_spawn_file_actions_init(&actions) == 0)
+    {
+        err = posix_spawn_file_actions_adddup2(&actions, sv[1], SPAWN_HELPER_FD);
+        if (!err)
+            err = posix_spawn(&g_global.helper.pid, "/proc/self/exe",
+                              &actions, NULL, argv, envp);
+        posix_spawn_file_actions_destroy(&actions);
+    }
+    if (sv[1] != -1)
+        close(sv[1]);
+    if (err)
+    {
+        close(sv[0]);
+        return (-1);
+    }
+    g_global.helper.fd = sv[0];
+    g_global.helper.env_gen = 0;
+    return (0);
+}
+
+/**
+ * helper_request - Serialize a command into the request buffer
+ * @req: Header to fill
+ * @cmd: Command
+ * @path: Resolved executable
+ * @envp: Environment for the new program
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+static int  helper_request(t_helper_req *req, t_cmd *cmd, const char *path,
+                           char **envp)
+{
+    t_strbuf    *sb;
+    int         err;
+    int         i;
+
+    sb = &g_global.helper.req;
+    sb->len = 0;
+    ft_bzero(req, sizeof(*req));
+    err = strbuf_append(sb, path, ft_strlen(path) + 1);
+    i = 0;
+    while (i < cmd->argc)
+    {
+        err |= strbuf_append(sb, cmd->argv[i], ft_strlen(cmd->argv[i]) + 1);
+        i++;
+    }
+    req->args_len = sb->len;
+    req->argc = cmd->argc;
+    req->envc = HELPER_ENV_SAME;
+
+    /* The environment only travels when it changed since the last send */
+    if (envp != g_global.env.envp
+        || g_global.env.envp_generation != g_global.helper.env_gen)
+    {
+        req->envc = 0;
+        while (envp[req->envc])
+        {
+            err |= strbuf_append(sb, envp[req->envc],
+                ft_strlen(envp[req->envc]) + 1);
+            req->envc++;
+        }
+        req->env_len = sb->len - req->args_len;
+    }
+    req->heredoc = (cmd->heredoc_fd >= 0 && cmd->redir_in < 0);
+    req->background = cmd->background;
+    return (err);
+}
+
+/**
+ * helper_send - Send a request with its descriptors
+ * @req: Header
+ * @fds: stdin, stdout, stderr, cwd and maybe the heredoc
+ *
+ * Return: 0 on success, -1 on error
+ */
+static int  helper_send(t_helper_req *req, int *fds)
+{
+    struct msghdr   msg;
+    struct iovec    iov[2];
+    char            cbuf[CMSG_SPACE(HELPER_FDS * sizeof(int))];
+    struct cmsghdr  *cm;
+    int             nfds;
+    ssize_t         n;
+
+    nfds = HELPER_FDS - 1 + req->heredoc;
+    ft_bzero(&msg, sizeof(msg));
+    ft_bzero(cbuf, sizeof(cbuf));
+    iov[0].iov_base = req;
+    iov[0].iov_len = sizeof(*req);
+    iov[1].iov_base = g_global.helper.req.data;
+    iov[1].iov_len = g_global.helper.req.len;
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+    msg.msg_control = cbuf;
+    msg.msg_controllen = CMSG_SPACE(nfds * sizeof(int));
+    cm = CMSG_FIRSTHDR(&msg);
+    cm->cmsg_level = SOL_SOCKET;
+    cm->cmsg_type = SCM_RIGHTS;
+    cm->cmsg_len = CMSG_LEN(nfds * sizeof(int));
+    memcpy(CMSG_DATA(cm), fds, nfds * sizeof(int));
+    do
+        n = sendmsg(g_global.helper.fd, &msg, MSG_NOSIGNAL);
+    while (n == -1 && errno == EINTR);
+    if (n < (ssize_t)sizeof(*req))
+        return (-1);
+
+    /* A large environment may not fit in one send */
+    n -= sizeof(*req);
+    return (send_full(g_global.helper.fd, g_global.helper.req.data + n,
+        g_global.helper.req.len - n));
+}
+
+/**
+ * helper_spawn - Start an external command through the helper
+ * @cmd: Command, as for spawn_command
+ * @path: Resolved executable
+ * @envp: Environment for the new program
+ *
+ * Return: Child pid, -1 on error (already reported), or 0 if the helper
+ *         is unavailable and the caller should use another backend
+ */
+pid_t   helper_spawn(t_cmd *cmd, const char *path, char **envp)
+{
+    t_helper_req    req;
+    int             fds[HELPER_FDS];
+    int32_t         reply;
+    int             err;
+
+    /* A forked child must not share its parent's helper */
+    if (g_global.helper.owner != getpid())
+    {
+        if (g_global.helper.fd >= 0)
+            close(g_global.helper.fd);
+        g_global.helper.fd = -1;
+        g_global.helper.owner = getpid();
+    }
+    if (g_global.helper.fd == -1
+        && (g_global.helper.failed || helper_start() == -1))
+    {
+        g_global.helper.failed = 1;
+        return (0);
+    }
+    if (helper_request(&req, cmd, path, envp) == -1)
+        return (0);
+    /* Redirections were opened by the shell and replace the pipes */
+    fds[0] = cmd->pipe_in >= 0 ? cmd->pipe_in : STDIN_FILENO;
+    if (cmd->redir_in >= 0)
+        fds[0] = cmd->redir_in;
+    fds[1] = cmd->pipe_out >= 0 ? cmd->pipe_out : STDOUT_FILENO;
+    if (cmd->redir_out >= 0)
+        fds[1] = cmd->redir_out;
+    fds[2] = cmd->pipe_err >= 0 ? cmd->pipe_err : STDERR_FILENO;
+    fds[3] = open(".", O_PATH | O_DIRECTORY | O_CLOEXEC);
+    fds[4] = cmd->heredoc_fd;
+    if (fds[3] == -1)
+        return (0);
+    err = helper_send(&req, fds);
+    close(fds[3]);
+
+    /* Nothing was started: the command can still go through posix_spawn */
+    if (err == -1)
+    {
+        helper_stop();
+        g_global.helper.failed = 1;
+        return (0);
+    }
+    if (read_full(g_global.helper.fd, &reply, sizeof(reply)) == -1)
+    {
+        fprintf(stderr, "%s: spawn helper exited\n", cmd->argv[0]);
+        helper_stop();
+        g_global.helper.failed = 1;
+        return (-1);
+    }
+    if (req.envc != HELPER_ENV_SAME)
+        g_global.helper.env_gen = envp == g_global.env.envp
+            ? g_global.env.envp_generation : 0;
+    if (reply < 0)
+    {
+        fprintf(stderr, "%s: %s\n", cmd->argv[0], strerror(-reply));
+        return (-1);
+    }
+    return (reply);
+}
+
+/**
+ * helper_stop - Shut down this process's helper
+ *
+ * Closing the socket makes the helper exit; it is reaped here so it does
+ * not linger as a zombie.
+ */
+void    helper_stop(void)
+{
+    if (g_global.helper.fd >= 0)
+    {
+        close(g_global.helper.fd);
+        if (g_global.helper.owner == getpid())
+            waitpid(g_global.helper.pid, NULL, 0);
+    }
+    g_global.helper.fd = -1;
+    strbuf_free(&g_global.helper.req);
+}
@@ -0,0 +1,187 @@
+/* stats.c - Hot-path counters and the shellstats builtin */
+/* Author: your_login */
+
+#include "minishell.h"
+#include <stddef.h>
+
+/*
+ * The counters listed in SHELL_STATS (minishell.h) are plain increments
+ * of g_global.stats fields at the sites they describe: no branch, no
+ * call, no atomic. Building with -DMINISHELL_NO_STATS compiles every
+ * STAT_* macro away.
+ *
+ *   shellstats [-j] [-r]   print the counters, as "name value" lines or
+ *                          (-j) a JSON object; -r resets them afterwards
+ *   --stats-json=FILE      write the JSON object to FILE at exit ("-" is
+ *                          stderr); also MINISHELL_STATS_JSON=FILE
+ *
+ * Counters are per process: forked children (pipeline builtins,
+ * substitutions) count into their own copy, which is discarded.
+ */
+
+typedef struct s_stat_field {
+    const char  *name;
+    size_t      offset;
+}   t_stat_field;
+
+#define STAT_FIELD(name)    {#name, offsetof(t_stats, name)},
+
+static const t_stat_field   g_stat_fields[] = {
+    SHELL_STATS(STAT_FIELD)
+};
+
+#define STAT_FIELD_COUNT    (sizeof(g_stat_fields) / sizeof(g_stat_fields[0]))
+
+/**
+ * stat_value - Read one counter
+ * @stats: Counter block
+ * @i: Index into g_stat_fields
+ *
+ * Return: Counter value
+ */
+static unsigned long    stat_value(const t_stats *stats, size_t i)
+{
+    return (*(const unsigned long *)((const char *)stats
+        + g_stat_fields[i].offset));
+}
+
+/**
+ * stats_format - Render every counter
+ * @sb: Buffer receiving the text
+ * @json: 1 for a one-line JSON object, 0 for "name value" lines
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+int     stats_format(t_strbuf *sb, int json)
+{
+    size_t  i;
+    int     err;
+
+    err = 0;
+    if (json)
+        err |= strbuf_putc(sb, '{');
+    i = 0;
+    while (i < STAT_FIELD_COUNT)
+    {
+        if (json && i > 0)
+            err |= strbuf_append(sb, ", ", 2);
+        if (json)
+            err |= strbuf_putc(sb, '"');
+        err |= strbuf_append(sb, g_stat_fields[i].name,
+            ft_strlen(g_stat_fields[i].name));
+        if (json)
+            err |= strbuf_append(sb, "\": ", 3);
+        else
+            err |= strbuf_putc(sb, ' ');
+        err |= strbuf_putnbr(sb, (long)stat_value(&g_global.stats, i));
+        if (!json)
+            err |= strbuf_putc(sb, '\n');
+        i++;
+    }
+    if (json)
+        err |= strbuf_append(sb, "}\n", 2);
+    return (err);
+}
+
+/**
+ * stats_flush - Write the counters as JSON at exit
+ *
+ * Only the process that enabled it writes, as with trace_flush.
+ */
+void    stats_flush(void)
+{
+    t_strbuf    sb;
+    FILE        *out;
+
+    if (!g_global.stats_json || g_global.stats_owner != getpid())
+        return;
+    strbuf_init(&sb);
+    if (stats_format(&sb, 1) == -1)
+    {
+        strbuf_free(&sb);
+        return;
+    }
+    out = stderr;
+    if (ft_strcmp(g_global.stats_json, "-") != 0)
+        out = fopen(g_global.stats_json, "w");
+    if (!out)
+        fprintf(stderr, "minishell: %s: %s\n", g_global.stats_json,
+            strerror(errno));
+    else
+    {
+        fwrite(sb.data, 1, sb.len, out);
+        if (out != stderr)
+            fclose(out);
+    }
+    strbuf_free(&sb);
+    free(g_global.stats_json);
+    g_global.stats_json = NULL;
+}
+
+/**
+ * stats_init - Write the counters as JSON when the shell exits
+ * @path: Output file, or "-" for stderr
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+int     stats_init(const char *path)
+{
+    int first;
+
+    first = (g_global.stats_json == NULL && g_global.stats_owner == 0);
+    free(g_global.stats_json);
+    g_global.stats_json = ft_strdup(path);
+    if (!g_global.stats_json)
+        return (-1);
+    g_global.stats_owner = getpid();
+
+    /* Also catches exit() from the exit builtin */
+    if (first)
+        atexit(stats_flush);
+    return (0);
+}
+
+/**
+ * ft_shellstats - Implement shellstats builtin
+ * @argv: Command arguments: -j for JSON, -r to reset after printing
+ * @argc: Argument count
+ *
+ * Return: 0 on success, 1 on write error, 2 on a usage error
+ */
+int     ft_shellstats(char **argv, int argc)
+{
+    t_strbuf    sb;
+    int         json;
+    int         reset;
+    int         i;
+
+    json = 0;
+    reset = 0;
+    i = 1;
+    while (i < argc)
+    {
+        if (ft_strcmp(argv[i], "-j") == 0)
+            json = 1;
+        else if (ft_strcmp(argv[i], "-r") == 0)
+            reset = 1;
+        else
+        {
+            fprintf(stderr, "shellstats: usage: shellstats [-j] [-r]\n");
+            g_global.exit_status = 2;
+            return (2);
+        }
+        i++;
+    }
+    strbuf_init(&sb);
+    if (stats_format(&sb, json) == -1)
+    {
+        strbuf_free(&sb);
+        return (g_global.exit_status = 1);
+    }
+    out_write(&g_global.out, sb.data, sb.len);
+    g_global.exit_status = builtin_flush("shellstats");
+    strbuf_free(&sb);
+    if (reset)
+        ft_bzero(&g_global.stats, sizeof(t_stats));
+    return (g_global.exit_status);
+}
@@ -0,0 +1,140 @@
+/* strbuf.c - Growable string buffer for Minishell */
+/* Author: your_login */
+
+#include "minishell.h"
+
+#define STRBUF_MIN_CAP  64
+
+/**
+ * strbuf_init - Initialize an empty buffer (no allocation)
+ * @sb: Buffer to initialize
+ */
+void    strbuf_init(t_strbuf *sb)
+{
+    sb->data = NULL;
+    sb->len = 0;
+    sb->cap = 0;
+}
+
+/**
+ * strbuf_reserve - Make room for at least extra more bytes plus a NUL
+ * @sb: Buffer
+ * @extra: Number of bytes about to be appended
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+int     strbuf_reserve(t_strbuf *sb, size_t extra)
+{
+    size_t  need;
+    size_t  cap;
+    char    *data;
+    
+    need = sb->len + extra + 1;
+    if (need <= sb->cap)
+        return (0);
+    cap = sb->cap;
+    if (cap < STRBUF_MIN_CAP)
+        cap = STRBUF_MIN_CAP;
+    while (cap < need)
+        cap *= 2;
+    STAT_INC(strbuf_grows);
+    data = malloc(cap);
+    if (!data)
+        return (-1);
+    if (sb->len)
+        memcpy(data, sb->data, sb->len);
+    free(sb->data);
+    sb->data = data;
+    sb->cap = cap;
+    return (0);
+}
+
+/**
+ * strbuf_append - Append n bytes
+ * @sb: Buffer
+ * @s: Bytes to append
+ * @n: Number of bytes
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+int     strbuf_append(t_strbuf *sb, const char *s, size_t n)
+{
+    if (strbuf_reserve(sb, n) == -1)
+        return (-1);
+    memcpy(sb->data + sb->len, s, n);
+    sb->len += n;
+    sb->data[sb->len] = '\0';
+    return (0);
+}
+
+/**
+ * strbuf_putc - Append a single character
+ * @sb: Buffer
+ * @c: Character to append
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+int     strbuf_putc(t_strbuf *sb, char c)
+{
+    if (strbuf_reserve(sb, 1) == -1)
+        return (-1);
+    sb->data[sb->len++] = c;
+    sb->data[sb->len] = '\0';
+    return (0);
+}
+
+/**
+ * strbuf_putnbr - Append a decimal integer
+ * @sb: Buffer
+ * @n: Number to append
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+int     strbuf_putnbr(t_strbuf *sb, long n)
+{
+    char            digits[24];
+    size_t          i;
+    unsigned long   u;
+    
+    i = sizeof(digits);
+    u = (unsigned long)n;
+    if (n < 0)
+        u = -(unsigned long)n;
+    digits[--i] = '0' + (u % 10);
+    while (u >= 10)
+    {
+        u /= 10;
+        digits[--i] = '0' + (u % 10);
+    }
+    if (n < 0)
+        digits[--i] = '-';
+    return (strbuf_append(sb, digits + i, sizeof(digits) - i));
+}
+
+/**
+ * strbuf_detach - Take ownership of the buffer contents
+ * @sb: Buffer, left empty afterwards
+ *
+ * Return: NUL-terminated heap string (never NULL unless out of memory)
+ */
+char    *strbuf_detach(t_strbuf *sb)
+{
+    char    *data;
+    
+    if (!sb->data && strbuf_reserve(sb, 0) == -1)
+        return (NULL);
+    sb->data[sb->len] = '\0';
+    data = sb->data;
+    strbuf_init(sb);
+    return (data);
+}
+
+/**
+ * strbuf_free - Release the buffer memory
+ * @sb: Buffer, left empty afterwards
+ */
+void    strbuf_free(t_strbuf *sb)
+{
+    free(sb->data);
+    strbuf_init(sb);
+}
@@ -0,0 +1,258 @@
+/* subst.c - Command substitution for Minishell */
+/* Author: your_login */
+
+#define _GNU_SOURCE
+#include "minishell.h"
+
+/*
+ * $(...) is replaced by the standard output of the command line inside
+ * it, minus trailing newlines. The inner line is tokenized, expanded and
+ * parsed by the shell itself, once, into the current line's arena. Then:
+ *
+ *   in-process  a single BUILTIN_PIPE_SAFE builtin with no redirections
+ *               (echo, pwd, env) runs in the shell with g_global.out
+ *               capturing into a buffer, so $(pwd) costs no process
+ *   forked      anything else runs in a forked child whose stdout is a
+ *               pipe; the shell reads it into a growable buffer until EOF
+ *
+ * Nothing goes through temporary files. The exit status of the inner
+ * line becomes $?.
+ *
+ * subst_end and quote_end let the lexer and unquote_word step over a
+ * whole $(...) so quotes and operators inside it stay with the inner line.
+ */
+
+/**
+ * quote_end - Find the quote closing a quoted part
+ * @s: Text
+ * @i: Offset of the opening quote
+ * @len: Length of s; scanning also stops at a NUL
+ *
+ * A $(...) inside double quotes is skipped as a whole, so it may contain
+ * double quotes of its own.
+ *
+ * Return: Offset of the closing quote, or -1 if it is missing
+ */
+long    quote_end(const char *s, size_t i, size_t len)
+{
+    char    q;
+    long    end;
+
+    q = s[i++];
+    while (i < len && s[i])
+    {
+        if (s[i] == q)
+            return ((long)i);
+        if (q == '"' && s[i] == '$' && i + 1 < len && s[i + 1] == '(')
+        {
+            end = subst_end(s, i + 2, len);
+            if (end == -1)
+                return (-1);
+            i = (size_t)end;
+        }
+        i++;
+    }
+    return (-1);
+}
+
+/**
+ * subst_end - Find the ')' closing a command substitution
+ * @s: Text
+ * @i: Offset just past "$("
+ * @len: Length of s; scanning also stops at a NUL
+ *
+ * Return: Offset of the closing ')', or -1 if it is missing
+ */
+long    subst_end(const char *s, size_t i, size_t len)
+{
+    long    end;
+    int     depth;
+
+    depth = 1;
+    while (i < len && s[i])
+    {
+        if (s[i] == '\'' || s[i] == '"')
+        {
+            end = quote_end(s, i, len);
+            if (end == -1)
+                return (-1);
+            i = (size_t)end;
+        }
+        else if (s[i] == '(')
+            depth++;
+        else if (s[i] == ')' && --depth == 0)
+            return ((long)i);
+        i++;
+    }
+    return (-1);
+}
+
+/**
+ * subst_in_process - Run a pure builtin with its output captured
+ * @cmd: Builtin command with no redirections
+ * @env: Environment store
+ * @out: Buffer receiving the output
+ */
+static void subst_in_process(t_cmd *cmd, t_env *env, t_strbuf *out)
+{
+    out_flush(&g_global.out);
+    g_global.out.capture = out;
+    cmd->builtin->fn(cmd, env);
+    out_flush(&g_global.out);
+    g_global.out.capture = NULL;
+}
+
+/**
+ * subst_read - Read a pipe until EOF
+ * @fd: Read end
+ * @out: Buffer receiving the data
+ *
+ * If the buffer cannot grow, the rest of the output is read and dropped,
+ * so the child never blocks on a full pipe while the shell waits for it.
+ */
+static void subst_read(int fd, t_strbuf *out)
+{
+    char    discard[4096];
+    ssize_t n;
+    int     full;
+
+    full = 0;
+    while (1)
+    {
+        if (!full && strbuf_reserve(out, 4096) == -1)
+            full = 1;
+        if (full)
+            n = read(fd, discard, sizeof(discard));
+        else
+            n = read(fd, out->data + out->len, out->cap - out->len - 1);
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return;
+        if (!full)
+            out->len += n;
+    }
+}
+
+/**
+ * subst_forked - Run a parsed line in a child, reading its output
+ * @cmds: Parsed commands
+ * @count: Number of commands
+ * @env: Environment store
+ * @out: Buffer receiving the output
+ */
+static void subst_forked(t_cmd *cmds, int count, t_env *env, t_strbuf *out)
+{
+    int     fds[2];
+    int     status;
+    pid_t   pid;
+
+    if (pipe2(fds, O_CLOEXEC) == -1)
+    {
+        fprintf(stderr, "minishell: pipe: %s\n", strerror(errno));
+        g_global.exit_status = 1;
+        return;
+    }
+    out_flush(&g_global.out);
+    fflush(stdout);
+    STAT_INC(forks);
+    pid = fork();
+    if (pid == 0)
+    {
+        close(fds[0]);
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[1]);
+        g_global.interactive = 0;
+        if (count == 1 && cmds[0].argc > 0 && !cmds[0].background)
+            execute_command(&cmds[0], env);
+        else
+            execute_pipeline(cmds, count, env);
+        out_flush(&g_global.out);
+        exit(g_global.exit_status);
+    }
+    close(fds[1]);
+    if (pid == -1)
+    {
+        fprintf(stderr, "minishell: fork: %s\n", strerror(errno));
+        close(fds[0]);
+        g_global.exit_status = 1;
+        return;
+    }
+    subst_read(fds[0], out);
+    close(fds[0]);
+    while (wait_child(pid, &status, 0) == -1 && errno == EINTR)
+        ;
+    g_global.exit_status = exit_status_from_wait(status);
+}
+
+/**
+ * subst_parse - Tokenize, expand and parse the inner line
+ * @text: Inner line
+ * @len: Its length
+ * @env: Environment store
+ * @count: Receives the number of commands
+ *
+ * g_global.scratch belongs to the expansion in progress, so the inner
+ * line is expanded with a scratch buffer of its own.
+ *
+ * Return: Commands in the line's arena, or NULL if there is nothing to run
+ */
+static t_cmd    *subst_parse(const char *text, size_t len, t_env *env,
+                             int *count)
+{
+    t_strbuf    saved;
+    t_tokens    *tokens;
+    t_cmd       *cmds;
+    char        *line;
+
+    line = arena_strndup(&g_global.arena, text, len);
+    if (!line)
+        return (NULL);
+    saved = g_global.scratch;
+    strbuf_init(&g_global.scratch);
+    cmds = NULL;
+    tokens = tokenize_input(line, &g_global.arena);
+    if (tokens && expand_tokens(tokens, env, &g_global.arena) == 0
+        && tokens->count > 0)
+        cmds = parse_tokens(tokens, &g_global.arena, count);
+    strbuf_free(&g_global.scratch);
+    g_global.scratch = saved;
+    return (cmds);
+}
+
+/**
+ * subst_append - Append the output of a command substitution
+ * @sb: Buffer receiving the result
+ * @text: Inner command line, without "$(" and ")"
+ * @len: Its length
+ * @env: Environment store
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+int     subst_append(t_strbuf *sb, const char *text, size_t len, t_env *env)
+{
+    t_strbuf    out;
+    t_cmd       *cmds;
+    int         count;
+    int         ret;
+
+    strbuf_init(&out);
+    cmds = subst_parse(text, len, env, &count);
+    if (cmds && count == 1 && cmds[0].argc > 0 && !cmds[0].background
+        && cmds[0].builtin && (cmds[0].builtin->flags & BUILTIN_PIPE_SAFE)
+        && cmds[0].nredirs == 0)
+        subst_in_process(&cmds[0], env, &out);
+    else if (cmds)
+        subst_forked(cmds, count, env, &out);
+    if (cmds)
+        close_heredocs(cmds, count);
+
+    /* Trailing newlines are removed, as in every POSIX shell */
+    while (out.len > 0 && out.data[out.len - 1] == '\n')
+        out.len--;
+    ret = 0;
+    if (out.len > 0)
+        ret = strbuf_append(sb, out.data, out.len);
+    strbuf_free(&out);
+    return (ret);
+}
@@ -0,0 +1,161 @@
+/* trace.c - Opt-in per-phase latency tracer for Minishell */
+/* Author: your_login */
+
+#include "minishell.h"
+#include <time.h>
+
+#define TRACE_RING_SIZE 65536   /* events kept; oldest are overwritten */
+
+/*
+ * Enabled with --trace=FILE or MINISHELL_TRACE=FILE. Each phase is timed
+ * with CLOCK_MONOTONIC (a vDSO call, no syscall) and stored as a fixed-size
+ * record in an in-memory ring buffer. Nothing is formatted or written
+ * until exit, when the ring is dumped as Chrome trace-event JSON (load it
+ * in chrome://tracing or Perfetto). When tracing is off, each probe costs
+ * a single branch on g_global.trace.enabled.
+ */
+
+/**
+ * trace_now - Read the monotonic clock
+ *
+ * Return: Nanoseconds since an arbitrary point
+ */
+unsigned long   trace_now(void)
+{
+    struct timespec ts;
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((unsigned long)ts.tv_sec * 1000000000UL + ts.tv_nsec);
+}
+
+/**
+ * trace_init - Enable tracing into a file
+ * @path: Output file, written at exit
+ *
+ * A later call (--trace after MINISHELL_TRACE) replaces the file and
+ * keeps the ring already allocated.
+ *
+ * Return: 0 on success, -1 on allocation failure
+ */
+int     trace_init(const char *path)
+{
+    t_trace *tr;
+    char    *copy;
+    int     first;
+    
+    tr = &g_global.trace;
+    first = (tr->events == NULL && tr->owner == 0);
+    if (!tr->events)
+        tr->events = malloc(TRACE_RING_SIZE * sizeof(t_trace_event));
+    copy = ft_strdup(path);
+    if (!tr->events || !copy)
+    {
+        free(tr->events);
+        free(copy);
+        free(tr->path);
+        tr->events = NULL;
+        tr->path = NULL;
+        tr->enabled = 0;
+        return (-1);
+    }
+    free(tr->path);
+    tr->path = copy;
+    tr->count = 0;
+    tr->owner = getpid();
+    tr->enabled = 1;
+    
+    /* Also catches exit() from the exit builtin */
+    if (first)
+        atexit(trace_flush);
+    return (0);
+}
+
+/**
+ * trace_record - Store one completed phase
+ * @name: Phase name (string literal)
+ * @start: Value of trace_now() when the phase began
+ * @detail: Optional short detail such as the command name, or NULL
+ */
+void    trace_record(const char *name, unsigned long start, const char *detail)
+{
+    t_trace_event   *ev;
+    
+    ev = &g_global.trace.events[g_global.trace.count % TRACE_RING_SIZE];
+    g_global.trace.count++;
+    ev->name = name;
+    ev->start = start;
+    ev->dur = trace_now() - start;
+    ev->detail[0] = '\0';
+    if (detail)
+        ft_strlcpy(ev->detail, detail, sizeof(ev->detail));
+}
+
+/**
+ * write_json_string - Write a string with JSON escaping
+ * @out: Output stream
+ * @s: String to write
+ */
+static void write_json_string(FILE *out, const char *s)
+{
+    fputc('"', out);
+    while (*s)
+    {
+        if (*s == '"' || *s == '\\')
+            fputc('\\', out);
+        if ((unsigned char)*s >= 0x20)
+            fputc(*s, out);
+        s++;
+    }
+    fputc('"', out);
+}
+
+/**
+ * trace_flush - Write the ring buffer as Chrome trace-event JSON
+ *
+ * Only the shell process that enabled tracing writes the file, so forked
+ * children that exit do not clobber it.
+ */
+void    trace_flush(void)
+{
+    t_trace         *tr;
+    t_trace_event   *ev;
+    FILE            *out;
+    unsigned long   i;
+    
+    tr = &g_global.trace;
+    if (!tr->enabled || tr->owner != getpid())
+        return;
+    tr->enabled = 0;
+    out = fopen(tr->path, "w");
+    if (!out)
+    {
+        fprintf(stderr, "minishell: %s: %s\n", tr->path, strerror(errno));
+        return;
+    }
+    fprintf(out, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    i = 0;
+    if (tr->count > TRACE_RING_SIZE)
+        i = tr->count - TRACE_RING_SIZE;
+    while (i < tr->count)
+    {
+        ev = &tr->events[i % TRACE_RING_SIZE];
+        fprintf(out, "{\"name\": \"%s\", \"ph\": \"X\", \"pid\": %d, "
+            "\"tid\": %d, \"ts\": %.3f, \"dur\": %.3f", ev->name,
+            (int)tr->owner, (int)tr->owner, ev->start / 1000.0,
+            ev->dur / 1000.0);
+        if (ev->detail[0])
+        {
+            fprintf(out, ", \"args\": {\"detail\": ");
+            write_json_string(out, ev->detail);
+            fputc('}', out);
+        }
+        fprintf(out, "}%s\n", (i + 1 < tr->count) ? "," : "");
+        i++;
+    }
+    fprintf(out, "]}\n");
+    fclose(out);
+    free(tr->events);
+    free(tr->path);
+    tr->events = NULL;
+    tr->path = NULL;
+}
@@ -0,0 +1,196 @@
+/* usage.c - Resource accounting, time and times builtins */
+/* Author: your_login */
+
+#include "minishell.h"
+#include <sys/resource.h>
+
+/*
+ * Every child the shell reaps goes through wait_child(), which uses
+ * wait4() and adds the child's rusage to the session totals in
+ * g_global.usage and, while a 'time' prefix is active, to its own
+ * accumulator (g_global.timing).
+ *
+ *   time PIPELINE   runs the line and reports wall, user and sys time,
+ *                   max RSS, page faults and context switches of the
+ *                   children plus the shell's own share (builtins)
+ *   times [-v]      shell and children user/sys time for the session;
+ *                   -v adds the full session accounting
+ *
+ * rusage times are kept in microseconds; maxrss is in KB, as Linux
+ * reports it, and is the largest single process, not a sum.
+ */
+
+/**
+ * usage_add - Add one rusage record to an accumulator
+ * @acc: Accumulator
+ * @ru: Record from wait4 or a getrusage delta
+ */
+static void usage_add(t_usage *acc, const struct rusage *ru)
+{
+    acc->utime_us += ru->ru_utime.tv_sec * 1000000L + ru->ru_utime.tv_usec;
+    acc->stime_us += ru->ru_stime.tv_sec * 1000000L + ru->ru_stime.tv_usec;
+    if (ru->ru_maxrss > acc->maxrss)
+        acc->maxrss = ru->ru_maxrss;
+    acc->minflt += ru->ru_minflt;
+    acc->majflt += ru->ru_majflt;
+    acc->nvcsw += ru->ru_nvcsw;
+    acc->nivcsw += ru->ru_nivcsw;
+}
+
+/**
+ * wait_child - waitpid() that records the child's resource usage
+ * @pid: Child to wait for
+ * @status: Receives the wait status
+ * @options: waitpid options (0 or WNOHANG)
+ *
+ * Return: As waitpid
+ */
+pid_t   wait_child(pid_t pid, int *status, int options)
+{
+    struct rusage   ru;
+    pid_t           ret;
+
+    ret = wait4(pid, status, options, &ru);
+    if (ret <= 0)
+        return (ret);
+    usage_add(&g_global.usage, &ru);
+    g_global.usage.procs++;
+    if (g_global.timing)
+    {
+        usage_add(g_global.timing, &ru);
+        g_global.timing->procs++;
+    }
+    return (ret);
+}
+
+/**
+ * time_begin - Start timing a command line
+ * @tm: Accumulator for the line
+ * @self: Receives the shell's own usage so far
+ */
+void    time_begin(t_usage *tm, struct rusage *self)
+{
+    ft_bzero(tm, sizeof(t_usage));
+    getrusage(RUSAGE_SELF, self);
+    tm->wall_ns = trace_now();
+    g_global.timing = tm;
+}
+
+/**
+ * format_seconds - Format a duration as bash does ("0m0.123s")
+ * @buf: Destination
+ * @size: Size of buf
+ * @us: Duration in microseconds
+ *
+ * Return: buf
+ */
+static char *format_seconds(char *buf, size_t size, long us)
+{
+    snprintf(buf, size, "%ldm%ld.%03lds", us / 60000000, us / 1000000 % 60,
+        us / 1000 % 1000);
+    return (buf);
+}
+
+/**
+ * time_end - Stop timing and print the report to stderr
+ * @tm: Accumulator from time_begin
+ * @self: Shell usage recorded by time_begin
+ */
+void    time_end(t_usage *tm, struct rusage *self)
+{
+    struct rusage   now;
+    char            buf[32];
+
+    tm->wall_ns = trace_now() - tm->wall_ns;
+    g_global.timing = NULL;
+
+    /* The shell's own share: builtins and expansion run in-process */
+    getrusage(RUSAGE_SELF, &now);
+    now.ru_utime.tv_sec -= self->ru_utime.tv_sec;
+    now.ru_utime.tv_usec -= self->ru_utime.tv_usec;
+    now.ru_stime.tv_sec -= self->ru_stime.tv_sec;
+    now.ru_stime.tv_usec -= self->ru_stime.tv_usec;
+    now.ru_minflt -= self->ru_minflt;
+    now.ru_majflt -= self->ru_majflt;
+    now.ru_nvcsw -= self->ru_nvcsw;
+    now.ru_nivcsw -= self->ru_nivcsw;
+
+    /* The shell's peak RSS only describes lines that started no process */
+    if (tm->procs > 0)
+        now.ru_maxrss = 0;
+    usage_add(tm, &now);
+
+    fprintf(stderr, "\nreal\t%s\n",
+        format_seconds(buf, sizeof(buf), (long)(tm->wall_ns / 1000)));
+    fprintf(stderr, "user\t%s\n", format_seconds(buf, sizeof(buf),
+        tm->utime_us));
+    fprintf(stderr, "sys\t%s\n", format_seconds(buf, sizeof(buf),
+        tm->stime_us));
+    fprintf(stderr, "maxrss\t%ld KB\n", tm->maxrss);
+    fprintf(stderr, "faults\t%ld minor, %ld major\n", tm->minflt,
+        tm->majflt);
+    fprintf(stderr, "ctxsw\t%ld voluntary, %ld involuntary\n", tm->nvcsw,
+        tm->nivcsw);
+}
+
+/**
+ * times_line - Queue one "user sys" line of times output
+ * @user_us: User time in microseconds
+ * @sys_us: System time in microseconds
+ */
+static void times_line(long user_us, long sys_us)
+{
+    char    buf[32];
+
+    out_str(&g_global.out, format_seconds(buf, sizeof(buf), user_us));
+    out_putc(&g_global.out, ' ');
+    out_str(&g_global.out, format_seconds(buf, sizeof(buf), sys_us));
+    out_putc(&g_global.out, '\n');
+}
+
+/**
+ * ft_times - Implement times builtin
+ * @argv: Command arguments
+ * @argc: Argument count
+ *
+ * Prints the shell's and then its children's user and sys time, as POSIX
+ * specifies. With -v, also the accounting of every child reaped this
+ * session.
+ *
+ * Return: 0 on success, 1 on write error, 2 on a usage error
+ */
+int     ft_times(char **argv, int argc)
+{
+    struct rusage   self;
+    t_usage         *u;
+    char            line[128];
+
+    if (argc > 2 || (argc == 2 && ft_strcmp(argv[1], "-v") != 0))
+    {
+        fprintf(stderr, "times: usage: times [-v]\n");
+        g_global.exit_status = 2;
+        return (2);
+    }
+    u = &g_global.usage;
+    getrusage(RUSAGE_SELF, &self);
+    times_line(self.ru_utime.tv_sec * 1000000L + self.ru_utime.tv_usec,
+        self.ru_stime.tv_sec * 1000000L + self.ru_stime.tv_usec);
+    times_line(u->utime_us, u->stime_us);
+    if (argc == 2)
+    {
+        snprintf(line, sizeof(line), "lines\t%lu, %.3fs executing\n",
+            (unsigned long)g_global.line_count, u->wall_ns / 1e9);
+        out_str(&g_global.out, line);
+        snprintf(line, sizeof(line), "procs\t%ld reaped, maxrss %ld KB "
+            "(shell %ld KB)\n", u->procs, u->maxrss, self.ru_maxrss);
+        out_str(&g_global.out, line);
+        snprintf(line, sizeof(line), "faults\t%ld minor, %ld major\n",
+            u->minflt, u->majflt);
+        out_str(&g_global.out, line);
+        snprintf(line, sizeof(line), "ctxsw\t%ld voluntary, %ld "
+            "involuntary\n", u->nvcsw, u->nivcsw);
+        out_str(&g_global.out, line);
+    }
+    g_global.exit_status = builtin_flush("times");
+    return (g_global.exit_status);
+}